@@ -15,6 +15,9 @@
 
 
 #include <deal.II/base/quadrature.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/std_cxx11/array.h>
+#include <deal.II/base/geometry_info.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/dofs/dof_accessor.h>
@@ -23,10 +26,130 @@
 #include <deal.II/fe/fe_dgt.h>
 #include <deal.II/fe/fe_values.h>
 
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <sstream>
 
 DEAL_II_NAMESPACE_OPEN
 
+
+namespace
+{
+  // return the exponents of the monomials of the complete polynomial space
+  // of the given degree in the order in which PolynomialSpace enumerates
+  // them, i.e., with the x-exponent running fastest, then y, then z
+  template <int dim>
+  Table<2,unsigned int>
+  compute_monomial_exponents (const unsigned int degree,
+                              const unsigned int n_monomials)
+  {
+    const unsigned int n_1d = degree+1;
+    Table<2,unsigned int> exponents (n_monomials, dim);
+
+    unsigned int k=0;
+    for (unsigned int iz=0; iz<(dim>2 ? n_1d : 1); ++iz)
+      for (unsigned int iy=0; iy<(dim>1 ? n_1d-iz : 1); ++iy)
+        for (unsigned int ix=0; ix<n_1d-iy-iz; ++ix, ++k)
+          {
+            exponents(k,0) = ix;
+            if (dim>1)
+              exponents(k,1) = iy;
+            if (dim>2)
+              exponents(k,2) = iz;
+          }
+    Assert (k == n_monomials, ExcInternalError());
+
+    return exponents;
+  }
+
+
+
+  // the mass matrix of the monomials with the given exponents on the axis
+  // parallel box [lower,upper], in the coordinates (x-c)/h scaled by the
+  // diagonal h of the box around its center c. only monomials that are
+  // even in all coordinates have nonzero integrals
+  template <int dim>
+  FullMatrix<double>
+  compute_box_mass_matrix (const Table<2,unsigned int> &exponents,
+                           const Point<dim>            &lower,
+                           const Point<dim>            &upper)
+  {
+    const unsigned int n = exponents.size(0);
+    const double h = lower.distance (upper);
+    FullMatrix<double> matrix (n, n);
+    for (unsigned int i=0; i<n; ++i)
+      for (unsigned int j=0; j<n; ++j)
+        {
+          double entry = 1.;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              const unsigned int e = exponents(i,d) + exponents(j,d);
+              const double half_width = 0.5 * (upper[d] - lower[d]) / h;
+              entry *= (e % 2 == 0 ?
+                        2. * h * std::pow (half_width, static_cast<int>(e+1)) / (e+1) :
+                        0.);
+            }
+          matrix(i,j) = entry;
+        }
+    return matrix;
+  }
+
+
+
+  // return the index of the monomial with the given exponents, or
+  // numbers::invalid_unsigned_int if there is none
+  template <int dim>
+  unsigned int
+  find_monomial (const Table<2,unsigned int> &exponents,
+                 const unsigned int         (&powers)[dim])
+  {
+    for (unsigned int i=0; i<exponents.size(0); ++i)
+      {
+        bool match = true;
+        for (unsigned int d=0; d<dim; ++d)
+          match = match && (exponents(i,d) == powers[d]);
+        if (match)
+          return i;
+      }
+    return numbers::invalid_unsigned_int;
+  }
+
+
+
+  // differentiate monomial i successively in the given directions. return
+  // the index of the resulting monomial and set @p factor to the factor
+  // that arises, or return numbers::invalid_unsigned_int if the derivative
+  // vanishes
+  template <int dim>
+  unsigned int
+  differentiate_monomial (const Table<2,unsigned int> &exponents,
+                          const unsigned int           i,
+                          const unsigned int          *directions,
+                          const unsigned int           n_directions,
+                          double                      &factor)
+  {
+    unsigned int powers[dim];
+    for (unsigned int d=0; d<dim; ++d)
+      powers[d] = exponents(i,d);
+
+    factor = 1.;
+    for (unsigned int n=0; n<n_directions; ++n)
+      {
+        if (powers[directions[n]] == 0)
+          {
+            factor = 0.;
+            return numbers::invalid_unsigned_int;
+          }
+        factor *= powers[directions[n]];
+        --powers[directions[n]];
+      }
+    return find_monomial<dim> (exponents, powers);
+  }
+}
+
+
+
 template <int dim, int spacedim>
 FE_DGT<dim,spacedim>::FE_DGT (const unsigned int degree)
   :
@@ -38,9 +161,139 @@ FE_DGT<dim,spacedim>::FE_DGT (const unsigned int degree)
     std::vector<ComponentMask>(
       FiniteElementData<dim>(get_dpo_vector(degree),1, degree).dofs_per_cell,
       std::vector<bool>(1,true))),
-  polynomial_space (Polynomials::Monomial<double>::generate_complete_basis(degree))
+  polynomial_space (Polynomials::Monomial<double>::generate_complete_basis(degree)),
+  monomial_exponents (compute_monomial_exponents<dim> (degree, this->dofs_per_cell)),
+  moment_exponents (compute_monomial_exponents<dim> (2*degree, get_dpo_vector(2*degree)[dim]))
 {
   const unsigned int n_dofs = this->dofs_per_cell;
+
+#ifdef DEBUG
+  // make sure we enumerate the monomials the same way as the polynomial
+  // space does
+  {
+    Point<dim> p;
+    for (unsigned int d=0; d<dim; ++d)
+      p[d] = 0.3 + 0.2*d;
+    for (unsigned int i=0; i<n_dofs; ++i)
+      {
+        double value = 1.;
+        for (unsigned int d=0; d<dim; ++d)
+          value *= std::pow (p[d], static_cast<int>(monomial_exponents(i,d)));
+        Assert (std::fabs (value - polynomial_space.compute_value (i, p)) < 1e-12,
+                ExcInternalError());
+      }
+  }
+#endif
+
+  monomial_degrees.resize (n_dofs);
+  monomial_factorials.resize (n_dofs);
+  for (unsigned int i=0; i<n_dofs; ++i)
+    {
+      monomial_degrees[i] = 0;
+      monomial_factorials[i] = 1.;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          monomial_degrees[i] += monomial_exponents(i,d);
+          for (unsigned int e=2; e<=monomial_exponents(i,d); ++e)
+            monomial_factorials[i] *= e;
+        }
+    }
+
+  // set up the maps that express the derivatives of the monomials through
+  // monomials of lower degree: d/dx_d x^a = a_d x^{a-e_d}. only the
+  // entries with ascending directions are used by fill_shape_data()
+  gradient_indices.reinit (n_dofs, dim);
+  gradient_factors.reinit (n_dofs, dim);
+  hessian_indices.reinit (n_dofs, dim, dim);
+  hessian_factors.reinit (n_dofs, dim, dim);
+  third_derivative_indices.reinit (n_dofs, dim, dim, dim);
+  third_derivative_factors.reinit (n_dofs, dim, dim, dim);
+  for (unsigned int i=0; i<n_dofs; ++i)
+    for (unsigned int d1=0; d1<dim; ++d1)
+      {
+        unsigned int directions[3] = { d1, 0, 0 };
+        gradient_indices(i,d1)
+          = differentiate_monomial<dim> (monomial_exponents, i, directions, 1,
+                                         gradient_factors(i,d1));
+        for (unsigned int d2=0; d2<dim; ++d2)
+          {
+            directions[1] = d2;
+            hessian_indices(i,d1,d2)
+              = differentiate_monomial<dim> (monomial_exponents, i, directions, 2,
+                                             hessian_factors(i,d1,d2));
+            for (unsigned int d3=0; d3<dim; ++d3)
+              {
+                directions[2] = d3;
+                third_derivative_indices(i,d1,d2,d3)
+                  = differentiate_monomial<dim> (monomial_exponents, i, directions, 3,
+                                                 third_derivative_factors(i,d1,d2,d3));
+              }
+          }
+      }
+
+  // the products of two shape functions, for the polynomial algebra on
+  // coefficients
+  product_indices.reinit (n_dofs, n_dofs);
+  product_moment_indices.reinit (n_dofs, n_dofs);
+  for (unsigned int i=0; i<n_dofs; ++i)
+    for (unsigned int j=0; j<n_dofs; ++j)
+      {
+        unsigned int powers[dim];
+        for (unsigned int d=0; d<dim; ++d)
+          powers[d] = monomial_exponents(i,d) + monomial_exponents(j,d);
+        product_moment_indices(i,j) = find_monomial<dim> (moment_exponents, powers);
+        product_indices(i,j)
+          = (monomial_degrees[i] + monomial_degrees[j] <= degree
+             ?
+             find_monomial<dim> (monomial_exponents, powers)
+             :
+             numbers::invalid_unsigned_int);
+        Assert (product_moment_indices(i,j) != numbers::invalid_unsigned_int,
+                ExcInternalError());
+      }
+
+  // the monomials in the coordinates of a face, in which the traces of the
+  // shape functions are expanded. in 1d, the trace is a single value
+  {
+    const unsigned int face_dim = (dim > 1 ? dim-1 : 1);
+    unsigned int n_face_monomials = 1;
+    for (unsigned int j=1; j<dim; ++j)
+      n_face_monomials = n_face_monomials * (degree+j) / j;
+    face_monomial_exponents
+      = compute_monomial_exponents<face_dim> ((dim > 1 ? degree : 0), n_face_monomials);
+
+    face_raise_indices.reinit (n_face_monomials, dim-1);
+    for (unsigned int m=0; m<n_face_monomials; ++m)
+      for (unsigned int k=0; k<dim-1; ++k)
+        {
+          unsigned int powers[face_dim];
+          for (unsigned int l=0; l<face_dim; ++l)
+            powers[l] = face_monomial_exponents(m,l);
+          ++powers[k];
+          face_raise_indices(m,k) = find_monomial<face_dim> (face_monomial_exponents, powers);
+        }
+  }
+
+  // the prolongation matrices re-expand the shape functions of the parent
+  // in those of each child, which is exact since the polynomial space is
+  // invariant under translation and scaling. the restriction matrices are
+  // the L2 projections from the children, R_i = M^{-1} P_i^T M_i, with the
+  // mass matrices M of the parent and M_i of child i. since the shape
+  // functions live in real space, both refer to the unit hypercube and are
+  // exact on cells that are scaled and translated copies of it. on other
+  // cells, the transfer depends on the geometry of the cell, see
+  // MGTransferDGT
+  Point<dim> unit_point;
+  for (unsigned int d=0; d<dim; ++d)
+    unit_point[d] = 1.;
+  Point<spacedim> parent_center;
+  for (unsigned int d=0; d<dim; ++d)
+    parent_center[d] = 0.5;
+  FullMatrix<double> inverse_mass_matrix
+    = compute_box_mass_matrix<dim> (monomial_exponents, Point<dim>(), unit_point);
+  inverse_mass_matrix.gauss_jordan ();
+  FullMatrix<double> reexpansion_matrix, projection (n_dofs, n_dofs);
+
   for (unsigned int ref_case = RefinementCase<dim>::cut_x;
        ref_case<RefinementCase<dim>::isotropic_refinement+1; ++ref_case)
     {
@@ -53,37 +306,29 @@ FE_DGT<dim,spacedim>::FE_DGT (const unsigned int degree)
       const unsigned int nc = GeometryInfo<dim>::n_children(RefinementCase<dim>(ref_case));
       for (unsigned int i=0; i<nc; ++i)
         {
-          this->prolongation[ref_case-1][i].reinit (n_dofs, n_dofs);
-          // Fill prolongation matrices with
-          // embedding operators
-          for (unsigned int j=0; j<n_dofs; ++j)
-            this->prolongation[ref_case-1][i](j,j) = 1.;
+          const Point<dim> lower
+            = GeometryInfo<dim>::child_to_cell_coordinates (Point<dim>(), i,
+                                                            RefinementCase<dim>(ref_case));
+          const Point<dim> upper
+            = GeometryInfo<dim>::child_to_cell_coordinates (unit_point, i,
+                                                            RefinementCase<dim>(ref_case));
+          Point<spacedim> child_center;
+          for (unsigned int d=0; d<dim; ++d)
+            child_center[d] = 0.5 * (lower[d] + upper[d]);
+
+          get_reexpansion_matrix (parent_center, unit_point.norm(),
+                                  child_center, lower.distance (upper),
+                                  reexpansion_matrix);
+          this->prolongation[ref_case-1][i] = reexpansion_matrix;
+
+          reexpansion_matrix.Tmmult (projection,
+                                     compute_box_mass_matrix<dim> (monomial_exponents,
+                                                                   lower, upper));
+          this->restriction[ref_case-1][i].reinit (n_dofs, n_dofs);
+          inverse_mass_matrix.mmult (this->restriction[ref_case-1][i], projection);
         }
     }
 
-  // restriction can be defined
-  // through projection for
-  // discontinuous elements, but is
-  // presently not implemented for DGT
-  // elements.
-  //
-  // if it were, then the following
-  // snippet would be the right code
-//    if ((degree < Matrices::n_projection_matrices) &&
-//        (Matrices::projection_matrices[degree] != 0))
-//      {
-//        restriction[0].fill (Matrices::projection_matrices[degree]);
-//      }
-//    else
-//                                   // matrix undefined, set size to zero
-//      for (unsigned int i=0;i<GeometryInfo<dim>::max_children_per_cell;++i)
-//        restriction[i].reinit(0, 0);
-  // since not implemented, set to
-  // "empty". however, that is done in the
-  // default constructor already, so do nothing
-//  for (unsigned int i=0;i<GeometryInfo<dim>::max_children_per_cell;++i)
-//    this->restriction[i].reinit(0, 0);
-
   // note further, that these
   // elements have neither support
   // nor face-support points, so
@@ -314,7 +559,8 @@ FE_DGT<dim,spacedim>::requires_update_flags (const UpdateFlags flags) const
 {
    UpdateFlags out = flags;
 
-  if (flags & (update_values | update_gradients | update_hessians))
+  if (flags & (update_values | update_gradients | update_hessians |
+               update_3rd_derivatives))
     out |= update_quadrature_points ;
 
   return out;
@@ -334,8 +580,7 @@ get_data (const UpdateFlags                                                    u
           dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> & ) const
 {
   // generate a new data object
-  typename FiniteElement<dim,spacedim>::InternalDataBase *data
-    = new typename FiniteElement<dim,spacedim>::InternalDataBase;
+  InternalData *data = new InternalData;
   data->update_each = requires_update_flags(update_flags);
 
   // other than that, there is nothing we can add here as discussed
@@ -351,6 +596,229 @@ get_data (const UpdateFlags                                                    u
 // Fill data of FEValues
 //---------------------------------------------------------------------------
 
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+fill_shape_data (const typename Triangulation<dim,spacedim>::cell_iterator           &cell,
+                 const std::vector<Point<spacedim> >                                 &quadrature_points,
+                 const typename FiniteElement<dim,spacedim>::InternalDataBase        &fe_internal,
+                 dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> &output_data) const
+{
+  Assert (fe_internal.update_each & update_quadrature_points, ExcInternalError());
+  Assert (dynamic_cast<const InternalData *> (&fe_internal) != 0, ExcInternalError());
+  const InternalData &fe_data = static_cast<const InternalData &> (fe_internal);
+
+  const UpdateFlags flags = fe_internal.update_each;
+  if (!(flags & (update_values | update_gradients | update_hessians |
+                 update_3rd_derivatives)))
+    return;
+
+  const unsigned int n_q_points = quadrature_points.size();
+  const unsigned int n_dofs = this->dofs_per_cell;
+
+  // the derivatives are gathered from the values, so we need the latter
+  // in double precision even if they were not requested or are written in
+  // single precision. compute them in place if possible
+  Table<2,float> *single_precision_values
+    = ((flags & update_values) ? fe_data.single_precision_values : 0);
+  Table<2,double> *values = 0;
+  if ((flags & update_values) && single_precision_values == 0)
+    values = &output_data.shape_values;
+  else if (flags & (update_gradients | update_hessians | update_3rd_derivatives))
+    {
+      if (fe_data.monomial_values.size(0) != n_dofs ||
+          fe_data.monomial_values.size(1) != n_q_points)
+        fe_data.monomial_values.reinit (n_dofs, n_q_points);
+      values = &fe_data.monomial_values;
+    }
+  if (single_precision_values != 0 &&
+      (single_precision_values->size(0) != n_dofs ||
+       single_precision_values->size(1) != n_q_points))
+    single_precision_values->reinit (n_dofs, n_q_points);
+
+  const double h = cell->diameter();
+  const Point<spacedim> center = cell->center();
+
+  // powers of the scaled coordinates, evaluated once per point
+  Table<2,double> powers (dim, this->degree+1);
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      const Point<dim> p = (Point<dim>)(quadrature_points[q] - center)/h;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          powers(d,0) = 1.;
+          for (unsigned int e=1; e<=this->degree; ++e)
+            powers(d,e) = powers(d,e-1) * p[d];
+        }
+
+      for (unsigned int k=0; k<n_dofs; ++k)
+        {
+          double value = powers(0,monomial_exponents(k,0));
+          for (unsigned int d=1; d<dim; ++d)
+            value *= powers(d,monomial_exponents(k,d));
+          if (values != 0)
+            (*values)(k,q) = value;
+          if (single_precision_values != 0)
+            (*single_precision_values)(k,q) = value;
+        }
+    }
+
+  if ((flags & update_gradients) && fe_data.gradient_components != 0)
+    fill_gradient_components (*values, h, *fe_data.gradient_components);
+  else if ((flags & update_gradients) && fe_data.single_precision_gradient_components != 0)
+    fill_gradient_components (*values, h, *fe_data.single_precision_gradient_components);
+  else if (flags & update_gradients)
+    {
+      const double inv_h = 1./h;
+      for (unsigned int k=0; k<n_dofs; ++k)
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            const unsigned int index = gradient_indices(k,d);
+            if (index == numbers::invalid_unsigned_int)
+              for (unsigned int q=0; q<n_q_points; ++q)
+                output_data.shape_gradients[k][q][d] = 0.;
+            else
+              {
+                const double factor = gradient_factors(k,d) * inv_h;
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_gradients[k][q][d] = factor * (*values)(index,q);
+              }
+          }
+    }
+
+  if ((flags & update_hessians) && fe_data.hessian_components != 0)
+    fill_hessian_components (*values, h, *fe_data.hessian_components);
+  else if ((flags & update_hessians) && fe_data.single_precision_hessian_components != 0)
+    fill_hessian_components (*values, h, *fe_data.single_precision_hessian_components);
+  else if (flags & update_hessians)
+    {
+      const double inv_h2 = 1./(h*h);
+      for (unsigned int k=0; k<n_dofs; ++k)
+        for (unsigned int d1=0; d1<dim; ++d1)
+          for (unsigned int d2=d1; d2<dim; ++d2)
+            {
+              const unsigned int index = hessian_indices(k,d1,d2);
+              if (index == numbers::invalid_unsigned_int)
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_hessians[k][q][d1][d2]
+                    = output_data.shape_hessians[k][q][d2][d1] = 0.;
+              else
+                {
+                  const double factor = hessian_factors(k,d1,d2) * inv_h2;
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    output_data.shape_hessians[k][q][d1][d2]
+                      = output_data.shape_hessians[k][q][d2][d1]
+                        = factor * (*values)(index,q);
+                }
+            }
+    }
+
+  if (flags & update_3rd_derivatives)
+    {
+      const double inv_h3 = 1./(h*h*h);
+      for (unsigned int k=0; k<n_dofs; ++k)
+        for (unsigned int d1=0; d1<dim; ++d1)
+          for (unsigned int d2=d1; d2<dim; ++d2)
+            for (unsigned int d3=d2; d3<dim; ++d3)
+              {
+                const unsigned int index = third_derivative_indices(k,d1,d2,d3);
+                const double factor = third_derivative_factors(k,d1,d2,d3) * inv_h3;
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  {
+                    const double value = (index == numbers::invalid_unsigned_int
+                                          ?
+                                          0.
+                                          :
+                                          factor * (*values)(index,q));
+                    Tensor<3,spacedim> &derivative = output_data.shape_3rd_derivatives[k][q];
+                    derivative[d1][d2][d3] = derivative[d1][d3][d2] = value;
+                    derivative[d2][d1][d3] = derivative[d2][d3][d1] = value;
+                    derivative[d3][d1][d2] = derivative[d3][d2][d1] = value;
+                  }
+              }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+template <typename Number>
+void
+FE_DGT<dim,spacedim>::
+fill_gradient_components (const Table<2,double> &values,
+                          const double           h,
+                          dealii::internal::FEValues::ShapeDerivativeComponents<1,spacedim,Number> &gradients) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  const unsigned int n_q_points = values.size(1);
+
+  // write one contiguous array per direction and shape function, see
+  // FEValuesBase::set_shape_derivative_layout()
+  gradients.reinit (n_dofs, n_q_points);
+  const double inv_h = 1./h;
+  for (unsigned int k=0; k<n_dofs; ++k)
+    for (unsigned int d=0; d<spacedim; ++d)
+      {
+        Number *gradient_ptr = gradients.component (d, k);
+        const unsigned int index = (d < dim ?
+                                    gradient_indices(k,d) :
+                                    numbers::invalid_unsigned_int);
+        if (index == numbers::invalid_unsigned_int)
+          for (unsigned int q=0; q<n_q_points; ++q)
+            gradient_ptr[q] = 0.;
+        else
+          {
+            const double factor = gradient_factors(k,d) * inv_h;
+            for (unsigned int q=0; q<n_q_points; ++q)
+              gradient_ptr[q] = factor * values(index,q);
+          }
+      }
+}
+
+
+
+template <int dim, int spacedim>
+template <typename Number>
+void
+FE_DGT<dim,spacedim>::
+fill_hessian_components (const Table<2,double> &values,
+                         const double           h,
+                         dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,Number> &hessians) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  const unsigned int n_q_points = values.size(1);
+
+  // write the independent components of the symmetric Hessians. each of
+  // them is a multiple of a single shape function value, given by the
+  // Hessian index maps for the entries on and above the diagonal
+  hessians.reinit (n_dofs, n_q_points);
+  const double inv_h2 = 1./(h*h);
+  for (unsigned int c=0; c<hessians.n_components; ++c)
+    {
+      const TableIndices<2> indices = hessians.component_indices (c);
+      const unsigned int d1 = std::min (indices[0], indices[1]);
+      const unsigned int d2 = std::max (indices[0], indices[1]);
+      for (unsigned int k=0; k<n_dofs; ++k)
+        {
+          Number *hessian_ptr = hessians.component (c, k);
+          const unsigned int index = (d2 < dim ?
+                                      hessian_indices(k,d1,d2) :
+                                      numbers::invalid_unsigned_int);
+          if (index == numbers::invalid_unsigned_int)
+            for (unsigned int q=0; q<n_q_points; ++q)
+              hessian_ptr[q] = 0.;
+          else
+            {
+              const double factor = hessian_factors(k,d1,d2) * inv_h2;
+              for (unsigned int q=0; q<n_q_points; ++q)
+                hessian_ptr[q] = factor * values(index,q);
+            }
+        }
+    }
+}
+
+
+
 template <int dim, int spacedim>
 void
 FE_DGT<dim,spacedim>::
@@ -363,39 +831,7 @@ fill_fe_values (const typename Triangulation<dim,spacedim>::cell_iterator & cell
                 const typename FiniteElement<dim,spacedim>::InternalDataBase        &fe_internal,
                 dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> &output_data) const
 {
-  Assert (fe_internal.update_each & update_quadrature_points, ExcInternalError());
-
-  const unsigned int n_q_points = mapping_data.quadrature_points.size();
-  
-  std::vector<double> values(fe_internal.update_each & update_values ? this->dofs_per_cell : 0);
-  std::vector<Tensor<1,dim> > grads(fe_internal.update_each & update_gradients ? this->dofs_per_cell : 0);
-  std::vector<Tensor<2,dim> > grad_grads(fe_internal.update_each & update_hessians ? this->dofs_per_cell : 0);
-  std::vector<Tensor<3,dim> > empty_vector_of_3rd_order_tensors; //not used
-  std::vector<Tensor<4,dim> > empty_vector_of_4th_order_tensors; 
-  
-  
-  double h = cell->diameter();
-
-  if (fe_internal.update_each & (update_values | update_gradients))
-    for (unsigned int i=0; i<n_q_points; ++i)
-      {
-        const Point<dim> p = (Point<dim>)(mapping_data.quadrature_points[i] - cell->center())/h;
-        polynomial_space.compute(p, //mapping_data.quadrature_points[i],
-                                 values, grads, grad_grads,
-                                 empty_vector_of_3rd_order_tensors,
-                                 empty_vector_of_4th_order_tensors);
-        if (fe_internal.update_each & update_values)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_values[k][i] = values[k];
-
-        if (fe_internal.update_each & update_gradients)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_gradients[k][i] = grads[k]/h;
-
-        if (fe_internal.update_each & update_hessians)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_hessians[k][i] = grad_grads[k]/h/h;
-      }
+  fill_shape_data (cell, mapping_data.quadrature_points, fe_internal, output_data);
 }
 
 
@@ -412,42 +848,7 @@ fill_fe_face_values (const typename Triangulation<dim,spacedim>::cell_iterator &
                      const typename FiniteElement<dim,spacedim>::InternalDataBase        &fe_internal,
                      dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> &output_data) const
 {
- 
-
-
-
-  Assert (fe_internal.update_each & update_quadrature_points, ExcInternalError());
-
-  const unsigned int n_q_points = mapping_data.quadrature_points.size();
-  
- std::vector<double> values(fe_internal.update_each & update_values ? this->dofs_per_cell : 0);
- std::vector<Tensor<1,dim> > grads(fe_internal.update_each & update_gradients ? this->dofs_per_cell : 0);
- std::vector<Tensor<2,dim> > grad_grads(fe_internal.update_each & update_hessians ? this->dofs_per_cell : 0);
- std::vector<Tensor<3,dim> > empty_vector_of_3rd_order_tensors; 
- std::vector<Tensor<4,dim> > empty_vector_of_4th_order_tensors;
- 
-  double h = cell->diameter();
-
-  if (fe_internal.update_each & (update_values | update_gradients))
-    for (unsigned int i=0; i<n_q_points; ++i)
-      {
-        const Point<dim> p =(Point<dim>) (mapping_data.quadrature_points[i] - cell->center())/h;
-        polynomial_space.compute(p, //mapping_data.quadrature_points[i],
-                                 values, grads, grad_grads,
-                                 empty_vector_of_3rd_order_tensors,
-                                 empty_vector_of_4th_order_tensors);
-        if (fe_internal.update_each & update_values)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_values[k][i] = values[k];
-
-        if (fe_internal.update_each & update_gradients)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_gradients[k][i] = grads[k]/h;
-
-        if (fe_internal.update_each & update_hessians)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_hessians[k][i] = grad_grads[k]/h/h;
-      }
+  fill_shape_data (cell, mapping_data.quadrature_points, fe_internal, output_data);
 }
 
 
@@ -465,38 +866,7 @@ fill_fe_subface_values (const typename Triangulation<dim,spacedim>::cell_iterato
                         const typename FiniteElement<dim,spacedim>::InternalDataBase        &fe_internal,
                         dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> &output_data) const
 {
-  Assert (fe_internal.update_each & update_quadrature_points, ExcInternalError());
-
-  const unsigned int n_q_points = mapping_data.quadrature_points.size();
-
-  std::vector<double> values(fe_internal.update_each & update_values ? this->dofs_per_cell : 0);
-  std::vector<Tensor<1,dim> > grads(fe_internal.update_each & update_gradients ? this->dofs_per_cell : 0);
-  std::vector<Tensor<2,dim> > grad_grads(fe_internal.update_each & update_hessians ? this->dofs_per_cell : 0);
-  std::vector<Tensor<3,dim> > empty_vector_of_3rd_order_tensors;
-  std::vector<Tensor<4,dim> > empty_vector_of_4th_order_tensors;
-  
-  double h = cell->diameter(); 
-
-  if (fe_internal.update_each & (update_values | update_gradients))
-    for (unsigned int i=0; i<n_q_points; ++i)
-      {
-        const Point<dim> p = (Point<dim>)(mapping_data.quadrature_points[i] - cell->center())/h;
-        polynomial_space.compute(p, //mapping_data.quadrature_points[i],
-                                 values, grads, grad_grads,
-                                 empty_vector_of_3rd_order_tensors,
-                                 empty_vector_of_4th_order_tensors);
-        if (fe_internal.update_each & update_values)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_values[k][i] = values[k];
-
-        if (fe_internal.update_each & update_gradients)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_gradients[k][i] = grads[k]/h;
-
-        if (fe_internal.update_each & update_hessians)
-          for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-            output_data.shape_hessians[k][i] = grad_grads[k]/h/h;//might want to add higher derivatives
-      }
+  fill_shape_data (cell, mapping_data.quadrature_points, fe_internal, output_data);
 }
 
 
@@ -672,6 +1042,1316 @@ FE_DGT<dim,spacedim>::get_degree () const
 
 
 
+template <int dim, int spacedim>
+const Table<2,unsigned int> &
+FE_DGT<dim,spacedim>::get_monomial_exponents () const
+{
+  return monomial_exponents;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FE_DGT<dim,spacedim>::get_monomial_index (const TableIndices<dim> &exponents) const
+{
+  unsigned int powers[dim];
+  for (unsigned int d=0; d<dim; ++d)
+    powers[d] = exponents[d];
+  return find_monomial<dim> (monomial_exponents, powers);
+}
+
+
+
+//---------------------------------------------------------------------------
+// ShapeClassCache
+//---------------------------------------------------------------------------
+
+template <int dim, int spacedim>
+FE_DGT<dim,spacedim>::ShapeClassCache::ShapeClassCache ()
+{}
+
+
+
+template <int dim, int spacedim>
+FE_DGT<dim,spacedim>::ShapeClassCache::
+ShapeClassCache (const FE_DGT<dim,spacedim>        &fe,
+                 const Triangulation<dim,spacedim> &triangulation)
+{
+  reinit (fe, triangulation);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::ShapeClassCache::
+reinit (const FE_DGT<dim,spacedim>        &fe,
+        const Triangulation<dim,spacedim> &triangulation)
+{
+  clear ();
+  this->fe = &fe;
+  this->triangulation = &triangulation;
+
+  // the key identifying the shape class of a cell are its vertices in
+  // scaled coordinates, rounded so that cells that are copies of each other
+  // up to roundoff end up in the same class
+  typedef std_cxx11::array<double,GeometryInfo<dim>::vertices_per_cell*dim> Key;
+  const double tolerance = 1e-10;
+  std::map<Key,unsigned int> class_indices;
+  std::vector<Point<dim> > vertices (GeometryInfo<dim>::vertices_per_cell);
+  Key key;
+
+  cell_classes.resize (triangulation.n_active_cells());
+  for (typename Triangulation<dim,spacedim>::active_cell_iterator
+       cell = triangulation.begin_active(); cell != triangulation.end(); ++cell)
+    {
+      const double h = cell->diameter();
+      const Point<spacedim> center = cell->center();
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          vertices[v] = (Point<dim>)(cell->vertex(v) - center)/h;
+          for (unsigned int d=0; d<dim; ++d)
+            key[v*dim+d] = std::floor (vertices[v][d]/tolerance + 0.5);
+        }
+
+      const std::pair<typename std::map<Key,unsigned int>::iterator,bool>
+      entry = class_indices.insert (std::make_pair (key, static_cast<unsigned int>(classes.size())));
+      if (entry.second)
+        classes.push_back (fe.compute_shape_class_data (vertices));
+      cell_classes[cell->active_cell_index()] = entry.first->second;
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::ShapeClassCache::clear ()
+{
+  thread_classes.clear ();
+  cell_classes.clear ();
+  classes.clear ();
+  fe = 0;
+  triangulation = 0;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FE_DGT<dim,spacedim>::ShapeClassCache::n_shape_classes () const
+{
+  return classes.size();
+}
+
+
+
+//---------------------------------------------------------------------------
+// Functions for WENO limiters
+//---------------------------------------------------------------------------
+
+template <int dim, int spacedim>
+std_cxx11::shared_ptr<const typename FE_DGT<dim,spacedim>::ShapeClassData>
+FE_DGT<dim,spacedim>::
+compute_shape_class_data (const std::vector<Point<dim> > &vertices) const
+{
+  std_cxx11::shared_ptr<ShapeClassData> data (new ShapeClassData);
+  data->vertices = vertices;
+
+  // integrate the monomials of degree up to 2k over the scaled cell,
+  // mapped d-linearly from the reference cell. the integrands are
+  // polynomials of degree at most 2k+dim-1 in each reference coordinate
+  const QGauss<dim> quadrature (this->degree + dim);
+  const unsigned int n_moments = moment_exponents.size(0);
+  data->monomial_moments.resize (n_moments, 0.);
+  for (unsigned int q=0; q<quadrature.size(); ++q)
+    {
+      Point<dim> x;
+      Tensor<2,dim> jacobian;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          const double shape = GeometryInfo<dim>::d_linear_shape_function (quadrature.point(q), v);
+          const Tensor<1,dim> shape_grad
+            = GeometryInfo<dim>::d_linear_shape_function_gradient (quadrature.point(q), v);
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              x[d] += shape * vertices[v][d];
+              for (unsigned int e=0; e<dim; ++e)
+                jacobian[d][e] += vertices[v][d] * shape_grad[e];
+            }
+        }
+      const double JxW = std::fabs (determinant (jacobian)) * quadrature.weight(q);
+
+      for (unsigned int m=0; m<n_moments; ++m)
+        {
+          double value = JxW;
+          for (unsigned int d=0; d<dim; ++d)
+            value *= std::pow (x[d], static_cast<int>(moment_exponents(m,d)));
+          data->monomial_moments[m] += value;
+        }
+    }
+
+  // the mean values of the shape functions. the first moment is the
+  // volume of the scaled cell
+  const unsigned int n_dofs = this->dofs_per_cell;
+  data->shape_function_averages.resize (n_dofs);
+  data->shape_function_integrals.resize (n_dofs);
+  for (unsigned int i=0; i<n_dofs; ++i)
+    {
+      unsigned int powers[dim];
+      for (unsigned int d=0; d<dim; ++d)
+        powers[d] = monomial_exponents(i,d);
+      data->shape_function_integrals[i]
+        = data->monomial_moments[find_monomial<dim> (moment_exponents, powers)];
+      data->shape_function_averages[i]
+        = data->shape_function_integrals[i] / data->monomial_moments[0];
+    }
+
+  return data;
+}
+
+
+
+template <int dim, int spacedim>
+typename FE_DGT<dim,spacedim>::ShapeClassReference &
+FE_DGT<dim,spacedim>::
+get_shape_class (const ShapeClassCache &shape_classes,
+                 const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  Assert (shape_classes.fe == this,
+          ExcMessage ("The ShapeClassCache was set up for a different element."));
+  Assert (shape_classes.triangulation == &cell->get_triangulation(),
+          ExcMessage ("The ShapeClassCache was set up for a different triangulation."));
+  AssertIndexRange (cell->active_cell_index(), shape_classes.cell_classes.size());
+  const unsigned int index = shape_classes.cell_classes[cell->active_cell_index()];
+
+  // each thread holds copies of the pointers to the data of the classes it
+  // has used, so that looking them up again needs no lock
+  std::vector<ShapeClassReference> &references = shape_classes.thread_classes.get();
+  if (references.size() != shape_classes.classes.size())
+    references.resize (shape_classes.classes.size());
+  ShapeClassReference &reference = references[index];
+  if (!reference.data)
+    reference.data = shape_classes.classes[index];
+  return reference;
+}
+
+
+
+template <int dim, int spacedim>
+const typename FE_DGT<dim,spacedim>::ShapeClassData &
+FE_DGT<dim,spacedim>::
+get_shape_class_data (const ShapeClassCache &shape_classes,
+                      const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  return *get_shape_class (shape_classes, cell).data;
+}
+
+
+
+template <int dim, int spacedim>
+const FullMatrix<double> &
+FE_DGT<dim,spacedim>::
+get_shape_class_matrix (const ShapeClassCache &shape_classes,
+                        const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                        const ShapeClassMatrix matrix,
+                        const unsigned int     index) const
+{
+  AssertIndexRange (matrix, n_shape_class_matrices);
+  ShapeClassReference &reference = get_shape_class (shape_classes, cell);
+  if (!reference.matrices[matrix])
+    {
+      Threads::Mutex::ScopedLock lock (reference.data->mutex);
+      compute_shape_class_matrices (*reference.data, matrix);
+      reference.matrices[matrix] = reference.data->matrices[matrix];
+    }
+  AssertIndexRange (index, reference.matrices[matrix]->size());
+  return (*reference.matrices[matrix])[index];
+}
+
+
+
+template <int dim, int spacedim>
+const std::vector<typename FE_DGT<dim,spacedim>::FaceTraceData> &
+FE_DGT<dim,spacedim>::
+get_face_traces (const ShapeClassCache &shape_classes,
+                 const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  ShapeClassReference &reference = get_shape_class (shape_classes, cell);
+  if (!reference.face_traces)
+    {
+      Threads::Mutex::ScopedLock lock (reference.data->mutex);
+      compute_face_traces (*reference.data);
+      reference.face_traces = reference.data->face_traces;
+    }
+  return *reference.face_traces;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+compute_shape_class_matrices (const ShapeClassData  &data,
+                              const ShapeClassMatrix matrix) const
+{
+  if (data.matrices[matrix])
+    return;
+
+  const unsigned int n_dofs = this->dofs_per_cell;
+  const std::vector<double> &moments = data.monomial_moments;
+  std_cxx11::shared_ptr<std::vector<FullMatrix<double> > >
+  matrices (new std::vector<FullMatrix<double> >);
+
+  // the element matrices consist of the moments of the products of two
+  // shape functions or their derivatives. the derivative of shape function
+  // j in direction d is gradient_factors(j,d)/h times shape function
+  // gradient_indices(j,d)
+  switch (matrix)
+    {
+    case cell_mass:
+      matrices->resize (1, FullMatrix<double>(n_dofs, n_dofs));
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int j=0; j<n_dofs; ++j)
+          (*matrices)[0](i,j) = moments[product_moment_indices(i,j)];
+      break;
+
+    case cell_inverse_mass:
+      compute_shape_class_matrices (data, cell_mass);
+      matrices->resize (1, (*data.matrices[cell_mass])[0]);
+      (*matrices)[0].gauss_jordan ();
+      break;
+
+    case cell_stiffness:
+      matrices->resize (1, FullMatrix<double>(n_dofs, n_dofs));
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int j=0; j<n_dofs; ++j)
+          for (unsigned int d=0; d<dim; ++d)
+            if (gradient_factors(i,d) != 0. && gradient_factors(j,d) != 0.)
+              (*matrices)[0](i,j)
+              += gradient_factors(i,d) * gradient_factors(j,d) *
+                 moments[product_moment_indices(gradient_indices(i,d),
+                                                gradient_indices(j,d))];
+      break;
+
+    case cell_derivatives:
+      matrices->resize (dim, FullMatrix<double>(n_dofs, n_dofs));
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int j=0; j<n_dofs; ++j)
+          for (unsigned int d=0; d<dim; ++d)
+            if (gradient_factors(j,d) != 0.)
+              (*matrices)[d](i,j)
+                = gradient_factors(j,d) *
+                  moments[product_moment_indices(i,gradient_indices(j,d))];
+      break;
+
+    case cell_smoothness:
+    {
+      // the derivative D^alpha of the monomial x^e is
+      // prod_d e_d!/(e_d-alpha_d)! x^{e-alpha}, so each entry is a sum of
+      // moments. the multi-indices alpha with |alpha|<=k are exactly the
+      // exponents of the shape functions, the first of which is alpha=0
+      matrices->resize (1, FullMatrix<double>(n_dofs, n_dofs));
+      FullMatrix<double> &smoothness = (*matrices)[0];
+      std::vector<double> factors (n_dofs);
+      Table<2,unsigned int> reduced_exponents (n_dofs, dim);
+      for (unsigned int alpha=1; alpha<n_dofs; ++alpha)
+        {
+          for (unsigned int i=0; i<n_dofs; ++i)
+            {
+              factors[i] = 1.;
+              for (unsigned int d=0; d<dim; ++d)
+                {
+                  if (monomial_exponents(i,d) < monomial_exponents(alpha,d))
+                    {
+                      factors[i] = 0.;
+                      break;
+                    }
+                  reduced_exponents(i,d) = monomial_exponents(i,d) - monomial_exponents(alpha,d);
+                  for (unsigned int e=reduced_exponents(i,d)+1; e<=monomial_exponents(i,d); ++e)
+                    factors[i] *= e;
+                }
+            }
+
+          for (unsigned int i=0; i<n_dofs; ++i)
+            if (factors[i] != 0.)
+              for (unsigned int j=i; j<n_dofs; ++j)
+                if (factors[j] != 0.)
+                  {
+                    unsigned int powers[dim];
+                    for (unsigned int d=0; d<dim; ++d)
+                      powers[d] = reduced_exponents(i,d) + reduced_exponents(j,d);
+                    const unsigned int index = find_monomial<dim> (moment_exponents, powers);
+                    Assert (index != numbers::invalid_unsigned_int, ExcInternalError());
+
+                    const double contribution = factors[i] * factors[j] * moments[index];
+                    smoothness(i,j) += contribution;
+                    if (j != i)
+                      smoothness(j,i) += contribution;
+                  }
+        }
+      break;
+    }
+
+    case face_mass:
+    case face_derivatives:
+    {
+      // the face element matrices, like the ones on the cell above
+      compute_face_traces (data);
+      const unsigned int n_directions = (matrix == face_mass ? 1 : dim);
+      matrices->resize (GeometryInfo<dim>::faces_per_cell * n_directions,
+                        FullMatrix<double>(n_dofs, n_dofs));
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          const std::vector<double> &face_moments = (*data.face_traces)[f].monomial_moments;
+          for (unsigned int i=0; i<n_dofs; ++i)
+            for (unsigned int j=0; j<n_dofs; ++j)
+              if (matrix == face_mass)
+                (*matrices)[f](i,j) = face_moments[product_moment_indices(i,j)];
+              else
+                for (unsigned int d=0; d<dim; ++d)
+                  if (gradient_factors(j,d) != 0.)
+                    (*matrices)[f*dim+d](i,j)
+                      = gradient_factors(j,d) *
+                        face_moments[product_moment_indices(i,gradient_indices(j,d))];
+        }
+      break;
+    }
+
+    default:
+      Assert (false, ExcNotImplemented());
+    }
+
+  data.matrices[matrix] = matrices;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+compute_face_traces (const ShapeClassData &data) const
+{
+  if (data.face_traces)
+    return;
+
+  // the geometry of the faces and the trace matrices. the trace of the
+  // monomial x^alpha on a face with center b and tangents t_k is the
+  // product over d of (b_d + sum_k t_{k,d} s_k)^{alpha_d}, expanded by
+  // repeated multiplication with these linear factors
+  const double tolerance = 1e-10;
+  const unsigned int n_dofs = this->dofs_per_cell;
+  const unsigned int n_moments = moment_exponents.size(0);
+  const unsigned int vertices_per_face = GeometryInfo<dim>::vertices_per_face;
+  const unsigned int n_face_monomials = face_monomial_exponents.size(0);
+  std_cxx11::shared_ptr<std::vector<FaceTraceData> >
+  face_traces (new std::vector<FaceTraceData> (GeometryInfo<dim>::faces_per_cell));
+  for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+    {
+      FaceTraceData &face = (*face_traces)[f];
+
+      std::vector<Point<dim> > face_vertices (vertices_per_face);
+      for (unsigned int v=0; v<vertices_per_face; ++v)
+        {
+          face_vertices[v] = data.vertices[GeometryInfo<dim>::face_to_cell_vertices (f, v)];
+          face.center += face_vertices[v] * (1./vertices_per_face);
+        }
+
+      // integrate the monomials over the face, mapped (d-1)-linearly from
+      // the reference face with a tensor product Gauss formula. in 1d, the
+      // face is a point
+      face.monomial_moments.resize (n_moments, 0.);
+      const QGauss<1> face_quadrature (this->degree+1);
+      const unsigned int n_q_1d = (dim > 1 ? face_quadrature.size() : 1);
+      for (unsigned int q1=0; q1<(dim > 2 ? n_q_1d : 1); ++q1)
+        for (unsigned int q0=0; q0<n_q_1d; ++q0)
+          {
+            Point<dim> x = face_vertices[0];
+            double JxW = 1.;
+            if (dim == 2)
+              {
+                const double xi = face_quadrature.point(q0)[0];
+                const Tensor<1,dim> edge = face_vertices[1] - face_vertices[0];
+                x += xi * edge;
+                JxW = edge.norm() * face_quadrature.weight(q0);
+              }
+            else if (dim == 3)
+              {
+                const double xi = face_quadrature.point(q0)[0];
+                const double eta = face_quadrature.point(q1)[0];
+                const Tensor<1,dim> d_xi = (1-eta) * (face_vertices[1] - face_vertices[0]) +
+                                           eta * (face_vertices[3] - face_vertices[2]);
+                const Tensor<1,dim> d_eta = (1-xi) * (face_vertices[2] - face_vertices[0]) +
+                                            xi * (face_vertices[3] - face_vertices[1]);
+                x += xi * (face_vertices[1] - face_vertices[0]) +
+                     eta * (face_vertices[2] - face_vertices[0]) +
+                     xi * eta * (face_vertices[3] - face_vertices[2] - face_vertices[1] + face_vertices[0]);
+                // the area element |d_xi x d_eta|
+                JxW = std::sqrt (d_xi.norm_square() * d_eta.norm_square() -
+                                 (d_xi * d_eta) * (d_xi * d_eta)) *
+                      face_quadrature.weight(q0) * face_quadrature.weight(q1);
+              }
+
+            for (unsigned int m=0; m<n_moments; ++m)
+              {
+                double value = JxW;
+                for (unsigned int d=0; d<dim; ++d)
+                  value *= std::pow (x[d], static_cast<int>(moment_exponents(m,d)));
+                face.monomial_moments[m] += value;
+              }
+          }
+
+      // orthonormalize the edges starting at the first vertex of the face,
+      // and check that the remaining vertex of a quadrilateral lies in the
+      // plane spanned by them
+      face.tangents.resize (dim-1);
+      for (unsigned int k=0; k<dim-1; ++k)
+        {
+          face.tangents[k] = face_vertices[1<<k] - face_vertices[0];
+          for (unsigned int l=0; l<k; ++l)
+            face.tangents[k] -= (face.tangents[k] * face.tangents[l]) * face.tangents[l];
+          face.tangents[k] /= face.tangents[k].norm();
+        }
+      face.is_flat = true;
+      if (dim == 3)
+        {
+          Tensor<1,dim> offset = face_vertices[vertices_per_face-1] - face_vertices[0];
+          for (unsigned int k=0; k<dim-1; ++k)
+            offset -= (offset * face.tangents[k]) * face.tangents[k];
+          face.is_flat = (offset.norm() < tolerance);
+        }
+      if (!face.is_flat)
+        continue;
+
+      face.trace_matrix.reinit (n_face_monomials, n_dofs);
+      Vector<double> trace (n_face_monomials);
+      Vector<double> tmp (n_face_monomials);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          trace = 0;
+          trace(0) = 1.;
+          for (unsigned int d=0; d<dim; ++d)
+            for (unsigned int e=0; e<monomial_exponents(i,d); ++e)
+              {
+                tmp = 0;
+                for (unsigned int m=0; m<n_face_monomials; ++m)
+                  if (trace(m) != 0.)
+                    {
+                      tmp(m) += trace(m) * face.center[d];
+                      for (unsigned int k=0; k<dim-1; ++k)
+                        if (face_raise_indices(m,k) != numbers::invalid_unsigned_int)
+                          tmp(face_raise_indices(m,k)) += trace(m) * face.tangents[k][d];
+                    }
+                trace.swap (tmp);
+              }
+          for (unsigned int m=0; m<n_face_monomials; ++m)
+            face.trace_matrix(m,i) = trace(m);
+        }
+    }
+
+  data.face_traces = face_traces;
+}
+
+
+
+template <int dim, int spacedim>
+const FullMatrix<double> &
+FE_DGT<dim,spacedim>::
+get_smoothness_matrix (const ShapeClassCache &shape_classes,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  return get_shape_class_matrix (shape_classes, cell, cell_smoothness);
+}
+
+
+
+template <int dim, int spacedim>
+double
+FE_DGT<dim,spacedim>::
+smoothness_indicator (const ShapeClassCache &shape_classes,
+                      const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                      const Vector<double> &coefficients) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  return get_smoothness_matrix (shape_classes, cell).matrix_norm_square (coefficients);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+smoothness_indicators (const ShapeClassCache &shape_classes,
+                       const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                       const FullMatrix<double> &coefficients,
+                       Vector<double>           &indicators) const
+{
+  AssertDimension (coefficients.m(), cells.size());
+  AssertDimension (coefficients.n(), this->dofs_per_cell);
+  AssertDimension (indicators.size(), cells.size());
+
+  const unsigned int n_dofs = this->dofs_per_cell;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      const FullMatrix<double> &matrix = get_smoothness_matrix (shape_classes, cells[c]);
+
+      double beta = 0;
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          double row = 0;
+          for (unsigned int j=0; j<n_dofs; ++j)
+            row += matrix(i,j) * coefficients(c,j);
+          beta += coefficients(c,i) * row;
+        }
+      indicators(c) = beta;
+    }
+}
+
+
+
+template <int dim, int spacedim>
+double
+FE_DGT<dim,spacedim>::
+cell_average (const ShapeClassCache &shape_classes,
+              const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+              const Vector<double> &coefficients) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  const std::vector<double> &averages = get_shape_class_data (shape_classes, cell).shape_function_averages;
+
+  double average = 0;
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    average += averages[i] * coefficients(i);
+  return average;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+coefficients_to_center_derivatives (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const Vector<double> &coefficients,
+                                    Vector<double>       &derivatives) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  AssertDimension (derivatives.size(), this->dofs_per_cell);
+
+  std::vector<double> inverse_h_powers (this->degree+1, 1.);
+  for (unsigned int m=1; m<=this->degree; ++m)
+    inverse_h_powers[m] = inverse_h_powers[m-1] / cell->diameter();
+
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    derivatives(i) = coefficients(i) * monomial_factorials[i] *
+                     inverse_h_powers[monomial_degrees[i]];
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+center_derivatives_to_coefficients (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const Vector<double> &derivatives,
+                                    Vector<double>       &coefficients) const
+{
+  AssertDimension (derivatives.size(), this->dofs_per_cell);
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+
+  std::vector<double> h_powers (this->degree+1, 1.);
+  for (unsigned int m=1; m<=this->degree; ++m)
+    h_powers[m] = h_powers[m-1] * cell->diameter();
+
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    coefficients(i) = derivatives(i) * h_powers[monomial_degrees[i]] /
+                      monomial_factorials[i];
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+coefficients_to_center_derivatives (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                    const FullMatrix<double> &coefficients,
+                                    FullMatrix<double>       &derivatives) const
+{
+  AssertDimension (coefficients.m(), cells.size());
+  AssertDimension (coefficients.n(), this->dofs_per_cell);
+  AssertDimension (derivatives.m(), cells.size());
+  AssertDimension (derivatives.n(), this->dofs_per_cell);
+
+  std::vector<double> inverse_h_powers (this->degree+1, 1.);
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      for (unsigned int m=1; m<=this->degree; ++m)
+        inverse_h_powers[m] = inverse_h_powers[m-1] / cells[c]->diameter();
+      for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+        derivatives(c,i) = coefficients(c,i) * monomial_factorials[i] *
+                           inverse_h_powers[monomial_degrees[i]];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+center_derivatives_to_coefficients (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                    const FullMatrix<double> &derivatives,
+                                    FullMatrix<double>       &coefficients) const
+{
+  AssertDimension (derivatives.m(), cells.size());
+  AssertDimension (derivatives.n(), this->dofs_per_cell);
+  AssertDimension (coefficients.m(), cells.size());
+  AssertDimension (coefficients.n(), this->dofs_per_cell);
+
+  std::vector<double> h_powers (this->degree+1, 1.);
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      for (unsigned int m=1; m<=this->degree; ++m)
+        h_powers[m] = h_powers[m-1] * cells[c]->diameter();
+      for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+        coefficients(c,i) = derivatives(c,i) * h_powers[monomial_degrees[i]] /
+                            monomial_factorials[i];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+Tensor<1,spacedim>
+FE_DGT<dim,spacedim>::
+center_gradient (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                 const Vector<double> &coefficients) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+
+  // only the linear shape functions contribute
+  Tensor<1,spacedim> gradient;
+  if (this->degree == 0)
+    return gradient;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      TableIndices<dim> exponents;
+      for (unsigned int e=0; e<dim; ++e)
+        exponents[e] = (e == d ? 1 : 0);
+      gradient[d] = coefficients(get_monomial_index (exponents)) / cell->diameter();
+    }
+  return gradient;
+}
+
+
+
+template <int dim, int spacedim>
+Tensor<2,spacedim>
+FE_DGT<dim,spacedim>::
+center_hessian (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                const Vector<double> &coefficients) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+
+  // only the quadratic shape functions contribute
+  Tensor<2,spacedim> hessian;
+  if (this->degree < 2)
+    return hessian;
+  const double inverse_h2 = 1./(cell->diameter()*cell->diameter());
+  for (unsigned int d1=0; d1<dim; ++d1)
+    for (unsigned int d2=d1; d2<dim; ++d2)
+      {
+        TableIndices<dim> exponents;
+        for (unsigned int e=0; e<dim; ++e)
+          exponents[e] = (e == d1 ? 1 : 0) + (e == d2 ? 1 : 0);
+        const unsigned int i = get_monomial_index (exponents);
+        hessian[d1][d2] = hessian[d2][d1]
+                          = coefficients(i) * monomial_factorials[i] * inverse_h2;
+      }
+  return hessian;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_shape_function_integrals (const ShapeClassCache &shape_classes,
+                              const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                              Vector<double> &integrals) const
+{
+  AssertDimension (integrals.size(), this->dofs_per_cell);
+  const std::vector<double> &scaled_integrals = get_shape_class_data (shape_classes, cell).shape_function_integrals;
+  const double volume_scaling = std::pow (cell->diameter(), static_cast<int>(dim));
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    integrals(i) = volume_scaling * scaled_integrals[i];
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+apply_inverse_mass_matrix (const ShapeClassCache &shape_classes,
+                           const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                           const Vector<double> &src,
+                           Vector<double>       &dst) const
+{
+  AssertDimension (src.size(), this->dofs_per_cell);
+  AssertDimension (dst.size(), this->dofs_per_cell);
+  get_shape_class_matrix (shape_classes, cell, cell_inverse_mass).vmult (dst, src);
+  dst /= std::pow (cell->diameter(), static_cast<int>(dim));
+}
+
+
+
+template <int dim, int spacedim>
+const FullMatrix<double> &
+FE_DGT<dim,spacedim>::
+get_scaled_inverse_mass_matrix (const ShapeClassCache &shape_classes,
+                                const typename Triangulation<dim,spacedim>::cell_iterator &cell) const
+{
+  return get_shape_class_matrix (shape_classes, cell, cell_inverse_mass);
+}
+
+
+
+template <int dim, int spacedim>
+double
+FE_DGT<dim,spacedim>::
+cell_moment (const ShapeClassCache &shape_classes,
+             const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+             const Vector<double>    &coefficients,
+             const TableIndices<dim> &exponents) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  unsigned int degree = 0;
+  for (unsigned int d=0; d<dim; ++d)
+    degree += exponents[d];
+  Assert (degree <= this->degree,
+          ExcMessage ("The total degree of the moment may not exceed the degree "
+                      "of the element."));
+  (void)degree;
+
+  // the product of shape function i with the weight is the monomial with
+  // the sum of the exponents, whose integral is among the moments of the
+  // shape class
+  const std::vector<double> &moments = get_shape_class_data (shape_classes, cell).monomial_moments;
+  double moment = 0;
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    {
+      unsigned int powers[dim];
+      for (unsigned int d=0; d<dim; ++d)
+        powers[d] = monomial_exponents(i,d) + exponents[d];
+      moment += coefficients(i) * moments[find_monomial<dim> (moment_exponents, powers)];
+    }
+  return moment * std::pow (cell->diameter(), static_cast<int>(dim));
+}
+
+
+
+template <int dim, int spacedim>
+double
+FE_DGT<dim,spacedim>::
+cell_integral (const ShapeClassCache &shape_classes,
+               const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+               const Vector<double> &coefficients) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  const std::vector<double> &scaled_integrals = get_shape_class_data (shape_classes, cell).shape_function_integrals;
+
+  double integral = 0;
+  for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+    integral += scaled_integrals[i] * coefficients(i);
+  return integral * std::pow (cell->diameter(), static_cast<int>(dim));
+}
+
+
+
+template <int dim, int spacedim>
+double
+FE_DGT<dim,spacedim>::
+integrate (const DoFHandler<dim,spacedim> &dof_handler,
+           const Vector<double>           &solution) const
+{
+  Assert (dof_handler.get_fe().get_name() == this->get_name(),
+          ExcMessage ("The DoFHandler must use this finite element."));
+  AssertDimension (solution.size(), dof_handler.n_dofs());
+
+  const unsigned int n_dofs = this->dofs_per_cell;
+  std::vector<types::global_dof_index> dof_indices (n_dofs);
+  const ShapeClassCache shape_classes (*this, dof_handler.get_triangulation());
+
+  double integral = 0;
+  for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      const std::vector<double> &scaled_integrals
+        = get_shape_class_data (shape_classes, cell).shape_function_integrals;
+
+      cell->get_dof_indices (dof_indices);
+      double cell_integral = 0;
+      for (unsigned int i=0; i<n_dofs; ++i)
+        cell_integral += scaled_integrals[i] * solution(dof_indices[i]);
+      integral += cell_integral * std::pow (cell->diameter(), static_cast<int>(dim));
+    }
+  return integral;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_mass_matrix (const ShapeClassCache &shape_classes,
+                 const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                 FullMatrix<double> &matrix) const
+{
+  matrix = get_shape_class_matrix (shape_classes, cell, cell_mass);
+  matrix *= std::pow (cell->diameter(), static_cast<int>(dim));
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_stiffness_matrix (const ShapeClassCache &shape_classes,
+                      const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                      FullMatrix<double> &matrix) const
+{
+  matrix = get_shape_class_matrix (shape_classes, cell, cell_stiffness);
+  matrix *= std::pow (cell->diameter(), static_cast<int>(dim)-2);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_derivative_matrix (const ShapeClassCache &shape_classes,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                       const unsigned int  direction,
+                       FullMatrix<double> &matrix) const
+{
+  AssertIndexRange (direction, dim);
+  matrix = get_shape_class_matrix (shape_classes, cell, cell_derivatives, direction);
+  matrix *= std::pow (cell->diameter(), static_cast<int>(dim)-1);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_face_mass_matrix (const ShapeClassCache &shape_classes,
+                      const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                      const unsigned int  face_no,
+                      FullMatrix<double> &matrix) const
+{
+  AssertIndexRange (face_no, GeometryInfo<dim>::faces_per_cell);
+  matrix = get_shape_class_matrix (shape_classes, cell, face_mass, face_no);
+  matrix *= std::pow (cell->diameter(), static_cast<int>(dim)-1);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_face_derivative_matrix (const ShapeClassCache &shape_classes,
+                            const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                            const unsigned int  face_no,
+                            const unsigned int  direction,
+                            FullMatrix<double> &matrix) const
+{
+  AssertIndexRange (face_no, GeometryInfo<dim>::faces_per_cell);
+  AssertIndexRange (direction, dim);
+  matrix = get_shape_class_matrix (shape_classes, cell, face_derivatives, face_no*dim+direction);
+  matrix *= std::pow (cell->diameter(), static_cast<int>(dim)-2);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_face_coupling_matrix (const ShapeClassCache &shape_classes,
+                          const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                          const unsigned int                                         face_no,
+                          const typename Triangulation<dim,spacedim>::cell_iterator &neighbor,
+                          FullMatrix<double>                                        &matrix) const
+{
+  FullMatrix<double> face_mass_matrix;
+  get_face_mass_matrix (shape_classes, cell, face_no, face_mass_matrix);
+
+  FullMatrix<double> reexpansion_matrix;
+  get_reexpansion_matrix (neighbor->center(), neighbor->diameter(),
+                          cell->center(), cell->diameter(),
+                          reexpansion_matrix);
+
+  matrix.reinit (this->dofs_per_cell, this->dofs_per_cell);
+  face_mass_matrix.mmult (matrix, reexpansion_matrix);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+multiply (const Vector<double> &a,
+          const Vector<double> &b,
+          Vector<double>       &product) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  AssertDimension (a.size(), n_dofs);
+  AssertDimension (b.size(), n_dofs);
+  AssertDimension (product.size(), n_dofs);
+  Assert (&product != &a && &product != &b,
+          ExcMessage ("The product may not be stored in one of the factors."));
+
+  product = 0;
+  for (unsigned int i=0; i<n_dofs; ++i)
+    if (a(i) != 0.)
+      for (unsigned int j=0; j<n_dofs; ++j)
+        {
+          const unsigned int index = product_indices(i,j);
+          if (index != numbers::invalid_unsigned_int)
+            product(index) += a(i) * b(j);
+        }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+square (const Vector<double> &a,
+        Vector<double>       &result) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  AssertDimension (a.size(), n_dofs);
+  AssertDimension (result.size(), n_dofs);
+  Assert (&result != &a,
+          ExcMessage ("The result may not be stored in the argument."));
+
+  result = 0;
+  for (unsigned int i=0; i<n_dofs; ++i)
+    if (a(i) != 0.)
+      {
+        if (product_indices(i,i) != numbers::invalid_unsigned_int)
+          result(product_indices(i,i)) += a(i) * a(i);
+        for (unsigned int j=i+1; j<n_dofs; ++j)
+          {
+            const unsigned int index = product_indices(i,j);
+            if (index != numbers::invalid_unsigned_int)
+              result(index) += 2. * a(i) * a(j);
+          }
+      }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+apply_polynomial (const std::vector<double> &polynomial,
+                  const Vector<double>      &u,
+                  Vector<double>            &result) const
+{
+  AssertDimension (u.size(), this->dofs_per_cell);
+  AssertDimension (result.size(), this->dofs_per_cell);
+  Assert (&result != &u,
+          ExcMessage ("The result may not be stored in the argument."));
+
+  result = 0;
+  if (polynomial.size() == 0)
+    return;
+
+  // Horner's scheme. the constant function is the first shape function
+  Vector<double> tmp (this->dofs_per_cell);
+  result(0) = polynomial.back();
+  for (unsigned int n=polynomial.size()-1; n>0; --n)
+    {
+      multiply (result, u, tmp);
+      result.swap (tmp);
+      result(0) += polynomial[n-1];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+integrate_against_shape_functions (const ShapeClassCache &shape_classes,
+                                   const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                   const Vector<double> &coefficients,
+                                   Vector<double>       &integrals) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  AssertDimension (coefficients.size(), n_dofs);
+  AssertDimension (integrals.size(), n_dofs);
+
+  const std::vector<double> &moments = get_shape_class_data (shape_classes, cell).monomial_moments;
+  const double volume_scaling = std::pow (cell->diameter(), static_cast<int>(dim));
+  for (unsigned int j=0; j<n_dofs; ++j)
+    {
+      double integral = 0;
+      for (unsigned int i=0; i<n_dofs; ++i)
+        integral += coefficients(i) * moments[product_moment_indices(i,j)];
+      integrals(j) = volume_scaling * integral;
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+integrate_against_shape_gradients (const ShapeClassCache &shape_classes,
+                                   const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                   const std::vector<Vector<double> > &flux,
+                                   Vector<double>                     &integrals) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  AssertDimension (flux.size(), dim);
+  AssertDimension (integrals.size(), n_dofs);
+
+  // the derivative of shape function j in direction d is
+  // gradient_factors(j,d)/h times shape function gradient_indices(j,d), so
+  // the integrands are again products of two shape functions
+  const std::vector<double> &moments = get_shape_class_data (shape_classes, cell).monomial_moments;
+  const double scaling = std::pow (cell->diameter(), static_cast<int>(dim)-1);
+  integrals = 0;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      AssertDimension (flux[d].size(), n_dofs);
+      for (unsigned int j=0; j<n_dofs; ++j)
+        if (gradient_factors(j,d) != 0.)
+          {
+            const unsigned int derivative = gradient_indices(j,d);
+            double integral = 0;
+            for (unsigned int i=0; i<n_dofs; ++i)
+              integral += flux[d](i) * moments[product_moment_indices(i,derivative)];
+            integrals(j) += scaling * gradient_factors(j,d) * integral;
+          }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FE_DGT<dim,spacedim>::n_face_trace_coefficients () const
+{
+  return face_monomial_exponents.size(0);
+}
+
+
+
+template <int dim, int spacedim>
+const typename FE_DGT<dim,spacedim>::FaceTraceData &
+FE_DGT<dim,spacedim>::
+get_face_trace_data (const ShapeClassCache &shape_classes,
+                     const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                     const unsigned int face_no) const
+{
+  AssertIndexRange (face_no, GeometryInfo<dim>::faces_per_cell);
+  const FaceTraceData &face = get_face_traces (shape_classes, cell)[face_no];
+  AssertThrow (face.is_flat,
+               ExcMessage ("Traces are only available on flat faces."));
+  return face;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+evaluate_face_monomials (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                         const FaceTraceData   &face,
+                         const Point<spacedim> &point,
+                         std::vector<double>   &values) const
+{
+  const Point<dim> x = (Point<dim>)(point - cell->center())/cell->diameter();
+  double s[dim > 1 ? dim-1 : 1];
+  for (unsigned int k=0; k<dim-1; ++k)
+    s[k] = face.tangents[k] * (x - face.center);
+
+  for (unsigned int m=0; m<values.size(); ++m)
+    {
+      values[m] = 1.;
+      for (unsigned int k=0; k<dim-1; ++k)
+        values[m] *= std::pow (s[k], static_cast<int>(face_monomial_exponents(m,k)));
+    }
+}
+
+
+
+template <int dim, int spacedim>
+const FullMatrix<double> &
+FE_DGT<dim,spacedim>::
+get_face_trace_matrix (const ShapeClassCache &shape_classes,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                       const unsigned int face_no) const
+{
+  return get_face_trace_data (shape_classes, cell, face_no).trace_matrix;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+face_trace (const ShapeClassCache &shape_classes,
+            const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+            const unsigned int    face_no,
+            const Vector<double> &coefficients,
+            Vector<double>       &trace) const
+{
+  AssertDimension (coefficients.size(), this->dofs_per_cell);
+  AssertDimension (trace.size(), n_face_trace_coefficients());
+  get_face_trace_matrix (shape_classes, cell, face_no).vmult (trace, coefficients);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+evaluate_face_trace (const ShapeClassCache &shape_classes,
+                     const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                     const unsigned int                   face_no,
+                     const Vector<double>                &trace,
+                     const std::vector<Point<spacedim> > &points,
+                     std::vector<double>                 &values) const
+{
+  const unsigned int n_face_monomials = n_face_trace_coefficients();
+  AssertDimension (trace.size(), n_face_monomials);
+  AssertDimension (values.size(), points.size());
+
+  const FaceTraceData &face = get_face_trace_data (shape_classes, cell, face_no);
+  std::vector<double> monomial_values (n_face_monomials);
+  for (unsigned int q=0; q<points.size(); ++q)
+    {
+      evaluate_face_monomials (cell, face, points[q], monomial_values);
+      values[q] = 0;
+      for (unsigned int m=0; m<n_face_monomials; ++m)
+        values[q] += trace(m) * monomial_values[m];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+integrate_against_face_traces (const ShapeClassCache &shape_classes,
+                               const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                               const unsigned int                   face_no,
+                               const std::vector<Point<spacedim> > &points,
+                               const std::vector<double>           &weighted_values,
+                               Vector<double>                      &integrals) const
+{
+  const unsigned int n_face_monomials = n_face_trace_coefficients();
+  AssertDimension (weighted_values.size(), points.size());
+  AssertDimension (integrals.size(), this->dofs_per_cell);
+
+  // integrate against the face monomials first, then map to the shape
+  // functions of the cell
+  const FaceTraceData &face = get_face_trace_data (shape_classes, cell, face_no);
+  std::vector<double> monomial_values (n_face_monomials);
+  Vector<double> face_integrals (n_face_monomials);
+  for (unsigned int q=0; q<points.size(); ++q)
+    {
+      evaluate_face_monomials (cell, face, points[q], monomial_values);
+      for (unsigned int m=0; m<n_face_monomials; ++m)
+        face_integrals(m) += weighted_values[q] * monomial_values[m];
+    }
+  face.trace_matrix.Tvmult (integrals, face_integrals);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+get_reexpansion_matrix (const Point<spacedim> &source_center,
+                        const double           source_diameter,
+                        const Point<spacedim> &target_center,
+                        const double           target_diameter,
+                        FullMatrix<double>    &matrix) const
+{
+  const unsigned int n_dofs = this->dofs_per_cell;
+  matrix.reinit (n_dofs, n_dofs);
+
+  // in the scaled coordinates y of the target, the scaled coordinates of
+  // the source read s*y+t. expanding (s*y_d+t_d)^e_d with the binomial
+  // theorem yields the entries of the matrix
+  const double s = target_diameter / source_diameter;
+  const Tensor<1,spacedim> t = (target_center - source_center) / source_diameter;
+
+  const unsigned int degree = this->degree;
+  Table<2,double> binomials (degree+1, degree+1);
+  for (unsigned int n=0; n<=degree; ++n)
+    {
+      binomials(n,0) = 1.;
+      for (unsigned int m=1; m<=n; ++m)
+        binomials(n,m) = binomials(n-1,m-1) + (m<n ? binomials(n-1,m) : 0.);
+    }
+
+  std::vector<double> s_powers (degree+1, 1.);
+  Table<2,double> t_powers (dim, degree+1);
+  for (unsigned int d=0; d<dim; ++d)
+    t_powers(d,0) = 1.;
+  for (unsigned int n=1; n<=degree; ++n)
+    {
+      s_powers[n] = s_powers[n-1] * s;
+      for (unsigned int d=0; d<dim; ++d)
+        t_powers(d,n) = t_powers(d,n-1) * t[d];
+    }
+
+  for (unsigned int i=0; i<n_dofs; ++i)
+    for (unsigned int j=0; j<n_dofs; ++j)
+      {
+        double entry = 1.;
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            const unsigned int e = monomial_exponents(i,d);
+            const unsigned int m = monomial_exponents(j,d);
+            if (m > e)
+              {
+                entry = 0.;
+                break;
+              }
+            entry *= binomials(e,m) * s_powers[m] * t_powers(d,e-m);
+          }
+        matrix(j,i) = entry;
+      }
+}
+
+
+
+template <int dim, int spacedim>
+void
+FE_DGT<dim,spacedim>::
+reexpand_coefficients (const typename Triangulation<dim,spacedim>::cell_iterator &source_cell,
+                       const Vector<double>                                       &source_coefficients,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &target_cell,
+                       Vector<double>                                             &target_coefficients) const
+{
+  AssertDimension (source_coefficients.size(), this->dofs_per_cell);
+  AssertDimension (target_coefficients.size(), this->dofs_per_cell);
+
+  FullMatrix<double> matrix;
+  get_reexpansion_matrix (source_cell->center(), source_cell->diameter(),
+                          target_cell->center(), target_cell->diameter(),
+                          matrix);
+  matrix.vmult (target_coefficients, source_coefficients);
+}
+
+
+
 // explicit instantiations
 #include "fe_dgt.inst"
 
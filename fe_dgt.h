@@ -19,9 +19,21 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/polynomial.h>
 #include <deal.II/base/polynomial_space.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
 #include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
 #include <deal.II/fe/mapping.h>
 
+#include <vector>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -326,6 +338,525 @@ public:
    */
   unsigned int get_degree () const;
 
+  /**
+   * Return the exponents of the monomials that form the shape functions:
+   * entry <tt>(i,d)</tt> is the power of the scaled coordinate @p d in
+   * shape function @p i. The monomials are ordered as in PolynomialSpace,
+   * i.e., by increasing powers of the last coordinate first, and for each
+   * of them by increasing powers of the previous coordinates.
+   */
+  const Table<2,unsigned int> &get_monomial_exponents () const;
+
+  /**
+   * Return the index of the shape function with the given exponents, or
+   * numbers::invalid_unsigned_int if the total degree of the exponents
+   * exceeds the degree of the element.
+   */
+  unsigned int get_monomial_index (const TableIndices<dim> &exponents) const;
+
+  /**
+   * The data that the functions below compute for each class of cells that
+   * are translated and scaled copies of each other, for the active cells of
+   * one triangulation. The functions that need it take an object of this
+   * type, which is owned by the algorithm using them, see the definition
+   * of this class below.
+   */
+  class ShapeClassCache;
+
+  /**
+   * @name Functions for WENO limiters
+   * @{
+   */
+
+  /**
+   * Return the matrix $B$ of the quadratic form that computes the smoothness
+   * indicator
+   * @f[
+   *   \beta = \sum_{1\le|\alpha|\le k} h^{2|\alpha|-d}
+   *            \int_K \left(D^\alpha u\right)^2 \, dx = c^T B c
+   * @f]
+   * of the function $u=\sum_i c_i \varphi_i$ on @p cell, where $h$ is the
+   * diameter of the cell and the sum runs over all multi-indices $\alpha$.
+   *
+   * Since the shape functions are monomials in the coordinates scaled by
+   * $h$, the powers of $h$ cancel and $B$ only depends on the shape of the
+   * cell. It is therefore computed once for all cells that are translated
+   * and scaled copies of each other, and cached in @p shape_classes. This
+   * function is thread-safe.
+   *
+   * The cell is assumed to be the image of the reference cell under a
+   * $d$-linear map.
+   */
+  const FullMatrix<double> &
+  get_smoothness_matrix (const ShapeClassCache &shape_classes,
+                         const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Return the smoothness indicator $\beta = c^T B c$ of the function with
+   * coefficients @p coefficients on @p cell, see get_smoothness_matrix().
+   */
+  double
+  smoothness_indicator (const ShapeClassCache &shape_classes,
+                        const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                        const Vector<double> &coefficients) const;
+
+  /**
+   * Same as above, but for a batch of cells. Row @p c of @p coefficients
+   * holds the coefficients of the function on <tt>cells[c]</tt>, and the
+   * smoothness indicator is written into <tt>indicators(c)</tt>.
+   */
+  void
+  smoothness_indicators (const ShapeClassCache &shape_classes,
+                         const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                         const FullMatrix<double> &coefficients,
+                         Vector<double>           &indicators) const;
+
+  /**
+   * Compute the matrix that maps the coefficients of a polynomial with
+   * respect to the shape functions centered at @p source_center and scaled
+   * by @p source_diameter to the coefficients of the same polynomial with
+   * respect to the shape functions centered at @p target_center and scaled
+   * by @p target_diameter. Since the polynomial space is invariant under
+   * translation and scaling, this re-expansion is exact.
+   */
+  void
+  get_reexpansion_matrix (const Point<spacedim> &source_center,
+                          const double           source_diameter,
+                          const Point<spacedim> &target_center,
+                          const double           target_diameter,
+                          FullMatrix<double>    &matrix) const;
+
+  /**
+   * Re-expand the polynomial with coefficients @p source_coefficients on
+   * @p source_cell in terms of the shape functions of @p target_cell, see
+   * get_reexpansion_matrix(). The polynomial is extended beyond the source
+   * cell, as needed for the reconstruction stencils of limiters.
+   */
+  void
+  reexpand_coefficients (const typename Triangulation<dim,spacedim>::cell_iterator &source_cell,
+                         const Vector<double>                                       &source_coefficients,
+                         const typename Triangulation<dim,spacedim>::cell_iterator &target_cell,
+                         Vector<double>                                             &target_coefficients) const;
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Derivatives at the center of a cell
+   *
+   * By construction, the coefficient of the shape function with exponents
+   * $\alpha$ on a cell with center $x_c$ and diameter $h$ equals
+   * $D^\alpha u(x_c) h^{|\alpha|}/\alpha!$. The functions in this group
+   * convert between the two representations without any evaluation and
+   * without a mapping.
+   * @{
+   */
+
+  /**
+   * Compute the derivatives $D^\alpha u(x_c)$ at the center of @p cell of
+   * the function with coefficients @p coefficients. The derivatives are
+   * ordered like the shape functions, see get_monomial_exponents().
+   */
+  void
+  coefficients_to_center_derivatives (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const Vector<double> &coefficients,
+                                      Vector<double>       &derivatives) const;
+
+  /**
+   * The inverse of coefficients_to_center_derivatives().
+   */
+  void
+  center_derivatives_to_coefficients (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const Vector<double> &derivatives,
+                                      Vector<double>       &coefficients) const;
+
+  /**
+   * Same as coefficients_to_center_derivatives(), but for a batch of cells.
+   * Row @p c of @p coefficients and @p derivatives belongs to
+   * <tt>cells[c]</tt>. The two matrices may be the same object.
+   */
+  void
+  coefficients_to_center_derivatives (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                      const FullMatrix<double> &coefficients,
+                                      FullMatrix<double>       &derivatives) const;
+
+  /**
+   * Same as center_derivatives_to_coefficients(), but for a batch of
+   * cells, see above.
+   */
+  void
+  center_derivatives_to_coefficients (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                      const FullMatrix<double> &derivatives,
+                                      FullMatrix<double>       &coefficients) const;
+
+  /**
+   * Return the gradient at the center of @p cell of the function with
+   * coefficients @p coefficients.
+   */
+  Tensor<1,spacedim>
+  center_gradient (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                   const Vector<double> &coefficients) const;
+
+  /**
+   * Return the Hessian at the center of @p cell of the function with
+   * coefficients @p coefficients.
+   */
+  Tensor<2,spacedim>
+  center_hessian (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                  const Vector<double> &coefficients) const;
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Integrals and moments
+   *
+   * The integrals of the shape functions over a cell only depend on the
+   * shape of the cell and a power of its diameter. They are computed once
+   * for each class of cells that are translated and scaled copies of each
+   * other, like the smoothness matrices above, so that integrals of finite
+   * element functions reduce to dot products with the coefficients and no
+   * FEValues object is needed.
+   * @{
+   */
+
+  /**
+   * Return the mean value over @p cell of the function with coefficients
+   * @p coefficients. Note that the first coefficient is the value at the
+   * center of the cell, which in general differs from the mean value.
+   */
+  double
+  cell_average (const ShapeClassCache &shape_classes,
+                const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                const Vector<double> &coefficients) const;
+
+  /**
+   * Return the integrals of the shape functions over @p cell in
+   * @p integrals, which must have <tt>dofs_per_cell</tt> elements.
+   */
+  void
+  get_shape_function_integrals (const ShapeClassCache &shape_classes,
+                                const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                Vector<double> &integrals) const;
+
+  /**
+   * Multiply @p src by the inverse of the mass matrix of this element on
+   * @p cell and write the result into @p dst. The mass matrix is the matrix
+   * of the integrals of the products of two shape functions, which is
+   * inverted once for each shape class.
+   */
+  void
+  apply_inverse_mass_matrix (const ShapeClassCache &shape_classes,
+                             const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                             const Vector<double> &src,
+                             Vector<double>       &dst) const;
+
+  /**
+   * Return the inverse of the mass matrix of @p cell multiplied by $h^d$,
+   * which only depends on the shape class of the cell. Algorithms that
+   * apply the inverse mass matrix of the same cells many times may store a
+   * reference to this matrix and the factor $h^{-d}$ for each cell instead
+   * of calling apply_inverse_mass_matrix(). The reference remains valid
+   * until @p shape_classes is cleared or reinitialized.
+   */
+  const FullMatrix<double> &
+  get_scaled_inverse_mass_matrix (const ShapeClassCache &shape_classes,
+                                  const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Return the moment
+   * @f[
+   *   \int_K u(x) \left(\frac{x-x_c}{h}\right)^\beta \, dx
+   * @f]
+   * of the function $u$ with coefficients @p coefficients on the cell $K$
+   * with center $x_c$ and diameter $h$, where the total degree of
+   * @p exponents $\beta$ may not exceed the degree of the element.
+   */
+  double
+  cell_moment (const ShapeClassCache &shape_classes,
+               const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+               const Vector<double>    &coefficients,
+               const TableIndices<dim> &exponents) const;
+
+  /**
+   * Return the integral over @p cell of the function with coefficients
+   * @p coefficients.
+   */
+  double
+  cell_integral (const ShapeClassCache &shape_classes,
+                 const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                 const Vector<double> &coefficients) const;
+
+  /**
+   * Return the integral over the whole domain of the finite element
+   * function @p solution defined on @p dof_handler, which must use this
+   * element. The active cells are sorted into shape classes by a
+   * ShapeClassCache local to this function, followed by a single pass over
+   * the active cells.
+   */
+  double
+  integrate (const DoFHandler<dim,spacedim> &dof_handler,
+             const Vector<double>           &solution) const;
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Element matrices
+   *
+   * Since the shape functions are monomials in <tt>(x-cell->center())/
+   * cell->diameter()</tt>, the element matrices of cells that are
+   * translated and scaled copies of each other only differ by a power of
+   * the diameter $h$. The matrices are assembled once for each such class
+   * of cells from the moments of the monomials over the cell and its faces
+   * and then rescaled, so that no quadrature is needed for any cell. The
+   * faces need not be flat. Each kind of matrix is assembled when it is
+   * first requested for a class, and looking up a class that the current
+   * thread has used before takes no lock.
+   * @{
+   */
+
+  /**
+   * Compute the mass matrix $\int_K \varphi_i \varphi_j \, dx = h^d
+   * \hat M_{ij}$ of @p cell.
+   */
+  void
+  get_mass_matrix (const ShapeClassCache &shape_classes,
+                   const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                   FullMatrix<double> &matrix) const;
+
+  /**
+   * Compute the stiffness matrix $\int_K \nabla\varphi_i \cdot
+   * \nabla\varphi_j \, dx = h^{d-2} \hat S_{ij}$ of @p cell.
+   */
+  void
+  get_stiffness_matrix (const ShapeClassCache &shape_classes,
+                        const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                        FullMatrix<double> &matrix) const;
+
+  /**
+   * Compute the matrix $\int_K \varphi_i \, \partial_d \varphi_j \, dx =
+   * h^{d-1} \hat C^{(d)}_{ij}$ of @p cell, from which advection matrices
+   * with constant velocity are linear combinations.
+   */
+  void
+  get_derivative_matrix (const ShapeClassCache &shape_classes,
+                         const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                         const unsigned int  direction,
+                         FullMatrix<double> &matrix) const;
+
+  /**
+   * Compute the face mass matrix $\int_F \varphi_i \varphi_j \, ds =
+   * h^{d-1} \hat F_{ij}$ of face @p face_no of @p cell.
+   */
+  void
+  get_face_mass_matrix (const ShapeClassCache &shape_classes,
+                        const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                        const unsigned int  face_no,
+                        FullMatrix<double> &matrix) const;
+
+  /**
+   * Compute the matrix $\int_F \varphi_i \, \partial_d \varphi_j \, ds =
+   * h^{d-2} \hat D^{(d)}_{ij}$ of face @p face_no of @p cell. Contracted
+   * with the normal vector of a flat face, this gives the normal
+   * derivative terms of interior penalty methods.
+   */
+  void
+  get_face_derivative_matrix (const ShapeClassCache &shape_classes,
+                              const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                              const unsigned int  face_no,
+                              const unsigned int  direction,
+                              FullMatrix<double> &matrix) const;
+
+  /**
+   * Compute the matrix $\int_F \varphi^K_i \varphi^N_j \, ds$ that couples
+   * the shape functions of @p cell, on its face @p face_no, with those of
+   * the neighbor @p neighbor. The shape functions of the neighbor are
+   * re-expanded about the center of @p cell by get_reexpansion_matrix(),
+   * which is exact, and the result is multiplied by the face mass matrix.
+   * The integral extends over the whole face of @p cell, so @p neighbor
+   * must be of the same size or coarser. On a refined face, compute the
+   * matrices from the side of the finer cells and transpose them.
+   */
+  void
+  get_face_coupling_matrix (const ShapeClassCache &shape_classes,
+                            const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                            const unsigned int                                         face_no,
+                            const typename Triangulation<dim,spacedim>::cell_iterator &neighbor,
+                            FullMatrix<double>                                        &matrix) const;
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Polynomial algebra on coefficients
+   *
+   * On a given cell, all functions of this element are polynomials in the
+   * same scaled variable <tt>(x-cell->center())/cell->diameter()</tt>, so
+   * sums and products can be formed directly on the coefficients. Products
+   * are truncated to the degree of the element, which is the Taylor
+   * expansion of the exact product about the center of the cell and
+   * accurate to the same order as the element. Together with the exact
+   * integration against the shape functions and their gradients below, this
+   * allows to assemble the volume terms of conservation laws with a
+   * polynomial flux, like linear advection or the Burgers equation, without
+   * evaluating anything at quadrature points.
+   * @{
+   */
+
+  /**
+   * Compute the coefficients of the product of the functions with
+   * coefficients @p a and @p b on the same cell, truncated to the degree
+   * of the element. @p product may not be the same object as @p a or
+   * @p b.
+   */
+  void
+  multiply (const Vector<double> &a,
+            const Vector<double> &b,
+            Vector<double>       &product) const;
+
+  /**
+   * Same as multiply() with both factors equal to @p a, but using the
+   * symmetry of the product.
+   */
+  void
+  square (const Vector<double> &a,
+          Vector<double>       &result) const;
+
+  /**
+   * Compute the coefficients of $p(u)=\sum_n p_n u^n$, truncated to the
+   * degree of the element, for the function $u$ with coefficients @p u and
+   * the polynomial coefficients $p_n$ given in @p polynomial. This is
+   * evaluated by Horner's scheme, i.e., with one call to multiply() for
+   * each power beyond the first. @p result may not be the same object as
+   * @p u.
+   */
+  void
+  apply_polynomial (const std::vector<double> &polynomial,
+                    const Vector<double>      &u,
+                    Vector<double>            &result) const;
+
+  /**
+   * Compute the integrals $\int_K u \varphi_j \, dx$ of the function with
+   * coefficients @p coefficients against all shape functions on @p cell.
+   * The integrands are polynomials of at most twice the degree of the
+   * element, so the integrals are exact and computed from the cached
+   * moments of the shape class of the cell.
+   */
+  void
+  integrate_against_shape_functions (const ShapeClassCache &shape_classes,
+                                     const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                     const Vector<double> &coefficients,
+                                     Vector<double>       &integrals) const;
+
+  /**
+   * Compute the integrals $\int_K \sum_d f_d \partial_d \varphi_j \, dx$ on
+   * @p cell for the vector valued function $f$ whose component $d$ has the
+   * coefficients <tt>flux[d]</tt>. This is the volume term of a
+   * discontinuous Galerkin discretization of $\partial_t u + \nabla\cdot
+   * f(u) = 0$. Like above, the integrals are exact.
+   */
+  void
+  integrate_against_shape_gradients (const ShapeClassCache &shape_classes,
+                                     const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                     const std::vector<Vector<double> > &flux,
+                                     Vector<double>                     &integrals) const;
+
+  /**
+   * @}
+   */
+
+  /**
+   * @name Traces on faces
+   *
+   * On a flat face, the restriction of a function of this element is a
+   * polynomial of the same degree in the <tt>dim-1</tt> face coordinates
+   * @f[
+   *   s_k = t_k \cdot \frac{x-x_f}{h},
+   * @f]
+   * where $x_f$ is the center of the face, $h$ the diameter of the cell,
+   * and $t_k$ are orthonormal tangent vectors of the face, the first one
+   * pointing from the first to the second vertex of the face. The trace
+   * polynomial is expanded in the monomials of the complete polynomial
+   * space in these coordinates, ordered like the shape functions of this
+   * element in <tt>dim-1</tt> space dimensions. It is obtained from the
+   * coefficients of the cell by a matrix that only depends on the shape of
+   * the cell, and is cached for each shape class and face like the
+   * smoothness matrices above. Evaluating the trace at face quadrature
+   * points is then much cheaper than evaluating all shape functions there,
+   * and the trace is a compact representation of the solution on a face,
+   * for example to be sent to the neighbor.
+   *
+   * In 1d, faces are points and the trace consists of the value there.
+   * @{
+   */
+
+  /**
+   * Return the number of coefficients of the trace polynomial on a face.
+   */
+  unsigned int
+  n_face_trace_coefficients () const;
+
+  /**
+   * Return the matrix that maps the coefficients of a function on @p cell
+   * to the coefficients of its trace polynomial on face @p face_no. The
+   * matrix has n_face_trace_coefficients() rows and <tt>dofs_per_cell</tt>
+   * columns.
+   */
+  const FullMatrix<double> &
+  get_face_trace_matrix (const ShapeClassCache &shape_classes,
+                         const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                         const unsigned int face_no) const;
+
+  /**
+   * Compute the coefficients @p trace of the trace polynomial on face
+   * @p face_no of @p cell of the function with coefficients
+   * @p coefficients.
+   */
+  void
+  face_trace (const ShapeClassCache &shape_classes,
+              const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+              const unsigned int    face_no,
+              const Vector<double> &coefficients,
+              Vector<double>       &trace) const;
+
+  /**
+   * Evaluate the trace polynomial with coefficients @p trace on face
+   * @p face_no of @p cell at the given points of the face in real space.
+   */
+  void
+  evaluate_face_trace (const ShapeClassCache &shape_classes,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                       const unsigned int                   face_no,
+                       const Vector<double>                &trace,
+                       const std::vector<Point<spacedim> > &points,
+                       std::vector<double>                 &values) const;
+
+  /**
+   * Compute the integrals $\int_F g \varphi_i \, ds$ over face @p face_no
+   * of @p cell against all shape functions of the cell by a quadrature
+   * rule with the given points. The function $g$ is passed in
+   * @p weighted_values as its values at the points multiplied by the
+   * quadrature weights, i.e., as the products $g(x_q) JxW_q$. Only the
+   * face monomials are evaluated at the points, the shape functions are
+   * then obtained through the transpose of the trace matrix.
+   */
+  void
+  integrate_against_face_traces (const ShapeClassCache &shape_classes,
+                                 const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                 const unsigned int                   face_no,
+                                 const std::vector<Point<spacedim> > &points,
+                                 const std::vector<double>           &weighted_values,
+                                 Vector<double>                      &integrals) const;
+
+  /**
+   * @}
+   */
+
   /**
    * Return the matrix
    * interpolating from a face of
@@ -613,6 +1144,52 @@ private:
   std::vector<unsigned int> 
   get_dpo_vector (const unsigned int degree);
 
+  /**
+   * Fill those fields of @p output_data selected by @p update_each at the
+   * points @p quadrature_points of @p cell. This is the common
+   * implementation of fill_fe_values(), fill_fe_face_values() and
+   * fill_fe_subface_values().
+   *
+   * Only the values of the monomials are computed at each point. Since the
+   * derivative of a scaled monomial is a multiple of another monomial of
+   * lower degree, gradients, Hessians and third derivatives are then
+   * gathered from the table of values using #gradient_indices,
+   * #hessian_indices, #third_derivative_indices and the corresponding
+   * factors. All requested orders are hence filled in one pass, and the
+   * values are computed only once even if only derivatives are requested.
+   *
+   * If FEValuesBase has connected its own tables to the internal data
+   * object (see internal::FEValues::ShapeTableTargets), the corresponding
+   * quantities are written there instead of into @p output_data.
+   */
+  void
+  fill_shape_data (const typename Triangulation<dim,spacedim>::cell_iterator           &cell,
+                   const std::vector<Point<spacedim> >                                 &quadrature_points,
+                   const typename FiniteElement<dim,spacedim>::InternalDataBase        &fe_internal,
+                   dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> &output_data) const;
+
+  /**
+   * Write the gradients of the shape functions on a cell of diameter @p h
+   * into @p gradients, with one contiguous array per direction and shape
+   * function, gathering them from the table @p values of the monomial
+   * values. Used by fill_shape_data() for the structure-of-arrays layout
+   * and for single precision tables.
+   */
+  template <typename Number>
+  void
+  fill_gradient_components (const Table<2,double> &values,
+                            const double           h,
+                            dealii::internal::FEValues::ShapeDerivativeComponents<1,spacedim,Number> &gradients) const;
+
+  /**
+   * Same as above, but for the independent components of the Hessians.
+   */
+  template <typename Number>
+  void
+  fill_hessian_components (const Table<2,double> &values,
+                           const double           h,
+                           dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,Number> &hessians) const;
+
  
   /**
    * Pointer to an object
@@ -621,6 +1198,291 @@ private:
    */
   const PolynomialSpace<dim> polynomial_space;
 
+  /**
+   * Exponents of the monomials spanning #polynomial_space, in the order in
+   * which PolynomialSpace enumerates them: <tt>monomial_exponents(i,d)</tt>
+   * is the power of coordinate @p d in shape function @p i.
+   */
+  Table<2,unsigned int> monomial_exponents;
+
+  /**
+   * The total degree $|\alpha|$ and the factorial $\alpha!$ of the exponents
+   * of each shape function, used to convert between coefficients and
+   * derivatives at the center of a cell.
+   */
+  std::vector<unsigned int> monomial_degrees;
+  std::vector<double>       monomial_factorials;
+
+  /**
+   * The derivative of shape function @p i in direction @p d, multiplied by
+   * the cell diameter $h$, equals <tt>gradient_factors(i,d)</tt> times
+   * shape function <tt>gradient_indices(i,d)</tt>. The index is
+   * numbers::invalid_unsigned_int if the derivative vanishes.
+   */
+  Table<2,unsigned int> gradient_indices;
+  Table<2,double>       gradient_factors;
+
+  /**
+   * Same as #gradient_indices and #gradient_factors, but for the second
+   * derivatives in directions <tt>d1,d2</tt>, multiplied by $h^2$.
+   */
+  Table<3,unsigned int> hessian_indices;
+  Table<3,double>       hessian_factors;
+
+  /**
+   * Same as #gradient_indices and #gradient_factors, but for the third
+   * derivatives in directions <tt>d1,d2,d3</tt>, multiplied by $h^3$.
+   */
+  Table<4,unsigned int> third_derivative_indices;
+  Table<4,double>       third_derivative_factors;
+
+  /**
+   * Scratch data for fill_shape_data(). Deriving from ShapeTableTargets
+   * allows FEValuesBase to receive the derivatives directly in the
+   * structure-of-arrays layout and all tables directly in single
+   * precision, see FEValuesBase::set_shape_derivative_layout() and
+   * FEValuesBase::set_shape_table_precision().
+   */
+  class InternalData : public FiniteElement<dim,spacedim>::InternalDataBase,
+    public dealii::internal::FEValues::ShapeTableTargets<spacedim>
+  {
+  public:
+    /**
+     * Values of the monomials at the quadrature points of the present cell.
+     * Only used if derivatives, but not the values themselves in double
+     * precision, are requested, since otherwise the values are computed in
+     * place in the output object.
+     */
+    mutable Table<2,double> monomial_values;
+  };
+
+
+  /**
+   * Exponents of the monomials of degree up to twice the degree of this
+   * element, in the same order as #monomial_exponents. These are the
+   * monomials arising as products of two shape functions.
+   */
+  Table<2,unsigned int> moment_exponents;
+
+  /**
+   * The index of the product of shape functions @p i and @p j among the
+   * shape functions, or numbers::invalid_unsigned_int if its degree exceeds
+   * the degree of the element. Used by multiply().
+   */
+  Table<2,unsigned int> product_indices;
+
+  /**
+   * The index of the product of shape functions @p i and @p j in
+   * #moment_exponents.
+   */
+  Table<2,unsigned int> product_moment_indices;
+
+  /**
+   * Exponents of the monomials in the coordinates of a face in which the
+   * traces of the shape functions are expanded. In 1d, there is a single
+   * constant monomial, represented with one zero exponent.
+   */
+  Table<2,unsigned int> face_monomial_exponents;
+
+  /**
+   * The index of the face monomial that results from multiplying face
+   * monomial @p m by the face coordinate @p k, or
+   * numbers::invalid_unsigned_int if its degree exceeds the degree of the
+   * element.
+   */
+  Table<2,unsigned int> face_raise_indices;
+
+  /**
+   * The geometry of a face in scaled coordinates, its moments and the
+   * trace matrix of the face, see get_face_trace_matrix().
+   */
+  struct FaceTraceData
+  {
+    /**
+     * Center of the face relative to the center of the cell, divided by the
+     * diameter of the cell.
+     */
+    Tensor<1,dim> center;
+
+    /**
+     * Orthonormal tangent vectors of the face.
+     */
+    std::vector<Tensor<1,dim> > tangents;
+
+    /**
+     * Integrals of the monomials listed in #moment_exponents over the face
+     * in scaled coordinates.
+     */
+    std::vector<double> monomial_moments;
+
+    /**
+     * Whether the face is flat. If not, the trace matrix is not set.
+     */
+    bool is_flat;
+
+    /**
+     * The trace matrix.
+     */
+    FullMatrix<double> trace_matrix;
+  };
+
+  /**
+   * The element matrices stored for each shape class, see
+   * get_shape_class_matrix().
+   */
+  enum ShapeClassMatrix
+  {
+    cell_mass,
+    cell_inverse_mass,
+    cell_stiffness,
+    cell_derivatives,
+    cell_smoothness,
+    face_mass,
+    face_derivatives,
+    n_shape_class_matrices
+  };
+
+  /**
+   * Data that depends on the shape of a cell but not on its position and
+   * size, i.e., that is shared by all cells that are translated and scaled
+   * copies of each other. The moments over the cell are computed when the
+   * first cell of a class is encountered, the matrices and the face data
+   * each when they are requested for the first time.
+   */
+  struct ShapeClassData
+  {
+    /**
+     * The vertices of the first cell of the class in the scaled coordinates
+     * <tt>(x-cell->center())/cell->diameter()</tt>.
+     */
+    std::vector<Point<dim> > vertices;
+
+    /**
+     * Integrals of the monomials listed in #moment_exponents over the cell
+     * in scaled coordinates.
+     */
+    std::vector<double> monomial_moments;
+
+    /**
+     * Mean values of the shape functions over the cell, used by
+     * cell_average().
+     */
+    std::vector<double> shape_function_averages;
+
+    /**
+     * Integrals of the shape functions over the cell in scaled coordinates,
+     * i.e., divided by $h^d$.
+     */
+    std::vector<double> shape_function_integrals;
+
+    /**
+     * The element matrices in scaled coordinates, indexed by
+     * ShapeClassMatrix, or null pointers if not yet computed. The
+     * derivative matrices are stored for each direction, the face mass
+     * matrices for each face and the face derivative matrices for each face
+     * and direction, with index <tt>face_no*dim+d</tt>. The inverse mass
+     * matrix is multiplied by $h^d$.
+     */
+    mutable std_cxx11::shared_ptr<const std::vector<FullMatrix<double> > > matrices[n_shape_class_matrices];
+
+    /**
+     * The geometry and trace matrices of the faces, or a null pointer if
+     * not yet computed.
+     */
+    mutable std_cxx11::shared_ptr<const std::vector<FaceTraceData> > face_traces;
+
+    /**
+     * Mutex guarding the computation of #matrices and #face_traces.
+     */
+    mutable Threads::Mutex mutex;
+  };
+
+  /**
+   * The entry of a shape class in ShapeClassCache for one thread. It holds
+   * copies of the pointers to the data of the class that the thread has
+   * already used, so that looking them up again needs no lock.
+   */
+  struct ShapeClassReference
+  {
+    std_cxx11::shared_ptr<const ShapeClassData> data;
+    std_cxx11::shared_ptr<const std::vector<FullMatrix<double> > > matrices[n_shape_class_matrices];
+    std_cxx11::shared_ptr<const std::vector<FaceTraceData> > face_traces;
+  };
+
+  /**
+   * Compute the moments of the shape class of a cell with the given
+   * vertices in scaled coordinates.
+   */
+  std_cxx11::shared_ptr<const ShapeClassData>
+  compute_shape_class_data (const std::vector<Point<dim> > &vertices) const;
+
+  /**
+   * Return the entry of the shape class of @p cell in @p shape_classes for
+   * the current thread.
+   */
+  ShapeClassReference &
+  get_shape_class (const ShapeClassCache &shape_classes,
+                   const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Return the data of the shape class of @p cell, see get_shape_class().
+   */
+  const ShapeClassData &
+  get_shape_class_data (const ShapeClassCache &shape_classes,
+                        const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Return the element matrix @p matrix with index @p index of the shape
+   * class of @p cell, computing the matrices of this kind if they are
+   * requested for the first time.
+   */
+  const FullMatrix<double> &
+  get_shape_class_matrix (const ShapeClassCache &shape_classes,
+                          const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                          const ShapeClassMatrix matrix,
+                          const unsigned int     index = 0) const;
+
+  /**
+   * Return the face data of the shape class of @p cell, computing it if it
+   * is requested for the first time.
+   */
+  const std::vector<FaceTraceData> &
+  get_face_traces (const ShapeClassCache &shape_classes,
+                   const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Compute the element matrices of kind @p matrix of the shape class
+   * @p data, unless this has already happened. The mutex of @p data must
+   * be locked.
+   */
+  void
+  compute_shape_class_matrices (const ShapeClassData  &data,
+                                const ShapeClassMatrix matrix) const;
+
+  /**
+   * Compute the face data of the shape class @p data, unless this has
+   * already happened. The mutex of @p data must be locked.
+   */
+  void
+  compute_face_traces (const ShapeClassData &data) const;
+
+  /**
+   * Return the face data of face @p face_no of @p cell, making sure that
+   * the face is flat.
+   */
+  const FaceTraceData &
+  get_face_trace_data (const ShapeClassCache &shape_classes,
+                       const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                       const unsigned int face_no) const;
+
+  /**
+   * Evaluate the face monomials at @p point on face @p face of @p cell.
+   */
+  void
+  evaluate_face_monomials (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                           const FaceTraceData   &face,
+                           const Point<spacedim> &point,
+                           std::vector<double>   &values) const;
 
   /**
    * Allow access from other dimensions.
@@ -631,6 +1493,87 @@ private:
 
 };
 
+
+
+/**
+ * The data that the functions of FE_DGT compute for each class of cells
+ * that are translated and scaled copies of each other: the moments of the
+ * monomials over the cells and, when they are first requested, the element
+ * matrices and the trace matrices of the faces.
+ *
+ * reinit() sorts the active cells of a triangulation into their classes
+ * once, so that finding the data of a cell is an index lookup by its
+ * active_cell_index(). The data is owned by this object and released by
+ * clear(), reinit() or the destructor, so that its lifetime is that of the
+ * algorithm using it rather than that of the finite element, which is
+ * usually shared. On meshes built by refinement the number of classes is
+ * small, but it may approach the number of cells on unstructured meshes.
+ *
+ * The functions of FE_DGT may use the same object from several threads, and
+ * looking up data that the current thread has used before takes no lock.
+ * reinit() and clear() must not be called while other threads use the
+ * object, and they invalidate the references returned by
+ * FE_DGT::get_smoothness_matrix() and FE_DGT::get_face_trace_matrix().
+ */
+template <int dim, int spacedim>
+class FE_DGT<dim,spacedim>::ShapeClassCache : public Subscriptor
+{
+public:
+  /**
+   * Constructor. The object is empty until reinit() is called.
+   */
+  ShapeClassCache ();
+
+  /**
+   * Constructor. Calls reinit().
+   */
+  ShapeClassCache (const FE_DGT<dim,spacedim>        &fe,
+                   const Triangulation<dim,spacedim> &triangulation);
+
+  /**
+   * Sort the active cells of @p triangulation into shape classes and
+   * compute the moments of each class for the element @p fe. Must be
+   * called again whenever the mesh changes.
+   */
+  void reinit (const FE_DGT<dim,spacedim>        &fe,
+               const Triangulation<dim,spacedim> &triangulation);
+
+  /**
+   * Release all data.
+   */
+  void clear ();
+
+  /**
+   * Return the number of shape classes.
+   */
+  unsigned int n_shape_classes () const;
+
+private:
+  /**
+   * The element and the triangulation this object was set up for.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,ShapeClassCache> fe;
+  SmartPointer<const Triangulation<dim,spacedim>,ShapeClassCache> triangulation;
+
+  /**
+   * The data of the shape classes.
+   */
+  std::vector<std_cxx11::shared_ptr<const ShapeClassData> > classes;
+
+  /**
+   * The index in #classes of the shape class of each active cell.
+   */
+  std::vector<unsigned int> cell_classes;
+
+  /**
+   * The entries of the shape classes for each thread, indexed like
+   * #classes.
+   */
+  mutable Threads::ThreadLocalStorage<std::vector<ShapeClassReference> > thread_classes;
+
+  friend class FE_DGT<dim,spacedim>;
+};
+
 /*@}*/
 
 #ifndef DOXYGEN
@@ -0,0 +1,366 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/fe/fe_dgt_ader_predictor.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+ADERPredictor<dim,spacedim>::
+ADERPredictor (const FE_DGT<dim,spacedim> &fe,
+               const Tensor<1,dim>        &advection_velocity)
+  :
+  fe (&fe, typeid(*this).name()),
+  equation (linear_advection),
+  advection_velocity (advection_velocity),
+  gamma (0.)
+{
+  initialize ();
+}
+
+
+
+template <int dim, int spacedim>
+ADERPredictor<dim,spacedim>::
+ADERPredictor (const FE_DGT<dim,spacedim> &fe,
+               const double                gamma)
+  :
+  fe (&fe, typeid(*this).name()),
+  equation (euler),
+  gamma (gamma)
+{
+  Assert (gamma > 1., ExcMessage ("The ratio of specific heats must exceed one."));
+  initialize ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::initialize ()
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const Table<2,unsigned int> &exponents = fe->get_monomial_exponents();
+
+  raise_indices.reinit (dofs_per_cell, dim);
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    {
+      TableIndices<dim> powers;
+      for (unsigned int d=0; d<dim; ++d)
+        powers[d] = exponents(i,d);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          ++powers[d];
+          raise_indices(i,d) = fe->get_monomial_index (powers);
+          --powers[d];
+        }
+    }
+
+  binomials.reinit (fe->degree+1, fe->degree+1);
+  for (unsigned int n=0; n<=fe->degree; ++n)
+    {
+      binomials(n,0) = 1.;
+      for (unsigned int j=1; j<=n; ++j)
+        binomials(n,j) = binomials(n-1,j-1) + (j<n ? binomials(n-1,j) : 0.);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+ADERPredictor<dim,spacedim>::n_components () const
+{
+  return (equation == euler ? dim+2 : 1);
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+compute_time_derivatives (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                          const std::vector<Vector<double> >         &coefficients,
+                          std::vector<std::vector<Vector<double> > > &time_derivatives) const
+{
+  std::vector<std::vector<std::vector<Vector<double> > > > fluxes;
+  compute_series (cell, coefficients, time_derivatives, fluxes);
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+predict (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+         const std::vector<Vector<double> >         &coefficients,
+         const double                                time_step,
+         std::vector<Vector<double> >               &averaged_solution,
+         std::vector<std::vector<Vector<double> > > &averaged_flux) const
+{
+  std::vector<std::vector<Vector<double> > > solution;
+  std::vector<std::vector<std::vector<Vector<double> > > > fluxes;
+  compute_series (cell, coefficients, solution, fluxes);
+
+  // the average of tau^n/n! over [0,dt] is dt^n/(n+1)!
+  const unsigned int n_orders = fe->degree+1;
+  std::vector<double> weights (n_orders);
+  weights[0] = 1.;
+  for (unsigned int n=1; n<n_orders; ++n)
+    weights[n] = weights[n-1] * time_step / (n+1);
+
+  const unsigned int n_dofs = fe->dofs_per_cell;
+  averaged_solution.resize (n_components());
+  averaged_flux.resize (n_components());
+  for (unsigned int c=0; c<n_components(); ++c)
+    {
+      averaged_solution[c].reinit (n_dofs);
+      for (unsigned int n=0; n<n_orders; ++n)
+        averaged_solution[c].add (weights[n], solution[c][n]);
+
+      averaged_flux[c].resize (dim);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          averaged_flux[c][d].reinit (n_dofs);
+          for (unsigned int n=0; n<n_orders; ++n)
+            averaged_flux[c][d].add (weights[n], fluxes[c][d][n]);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+evaluate_in_time (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                  const std::vector<Vector<double> > &coefficients,
+                  const double                        tau,
+                  std::vector<Vector<double> >       &solution) const
+{
+  std::vector<std::vector<Vector<double> > > time_derivatives;
+  compute_time_derivatives (cell, coefficients, time_derivatives);
+
+  solution.resize (n_components());
+  for (unsigned int c=0; c<n_components(); ++c)
+    {
+      solution[c].reinit (fe->dofs_per_cell);
+      double weight = 1.;
+      for (unsigned int n=0; n<=fe->degree; ++n)
+        {
+          solution[c].add (weight, time_derivatives[c][n]);
+          weight *= tau / (n+1);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+compute_series (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                const std::vector<Vector<double> >                      &coefficients,
+                std::vector<std::vector<Vector<double> > >              &solution,
+                std::vector<std::vector<std::vector<Vector<double> > > > &fluxes) const
+{
+  const unsigned int n_dofs = fe->dofs_per_cell;
+  const unsigned int n_orders = fe->degree+1;
+  const unsigned int n_comp = n_components();
+  AssertDimension (coefficients.size(), n_comp);
+
+  solution.resize (n_comp);
+  fluxes.resize (n_comp);
+  for (unsigned int c=0; c<n_comp; ++c)
+    {
+      AssertDimension (coefficients[c].size(), n_dofs);
+      solution[c].resize (n_orders, Vector<double>(n_dofs));
+      solution[c][0] = coefficients[c];
+      fluxes[c].resize (dim, std::vector<Vector<double> > (n_orders, Vector<double>(n_dofs)));
+    }
+
+  // the series of the auxiliary quantities of the Euler equations
+  std::vector<Vector<double> > inverse_density;
+  std::vector<std::vector<Vector<double> > > velocity;
+  std::vector<Vector<double> > pressure;
+  std::vector<Vector<double> > enthalpy;
+  if (equation == euler)
+    {
+      inverse_density.resize (n_orders, Vector<double>(n_dofs));
+      velocity.resize (dim, std::vector<Vector<double> > (n_orders, Vector<double>(n_dofs)));
+      pressure.resize (n_orders, Vector<double>(n_dofs));
+      enthalpy.resize (n_orders, Vector<double>(n_dofs));
+    }
+
+  const double h = cell->diameter();
+  for (unsigned int n=0; n<n_orders; ++n)
+    {
+      switch (equation)
+        {
+        case linear_advection:
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              fluxes[0][d][n] = solution[0][n];
+              fluxes[0][d][n] *= advection_velocity[d];
+            }
+          break;
+
+        case euler:
+          compute_euler_fluxes (n, solution, inverse_density, velocity,
+                                pressure, enthalpy, fluxes);
+          break;
+
+        default:
+          Assert (false, ExcNotImplemented());
+        }
+
+      // the next time derivative is minus the divergence of the flux
+      if (n+1 < n_orders)
+        for (unsigned int c=0; c<n_comp; ++c)
+          for (unsigned int d=0; d<dim; ++d)
+            add_derivative (fluxes[c][d][n], d, h, -1., solution[c][n+1]);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+compute_euler_fluxes (const unsigned int                                        n,
+                      const std::vector<std::vector<Vector<double> > >         &solution,
+                      std::vector<Vector<double> >                             &inverse_density,
+                      std::vector<std::vector<Vector<double> > >               &velocity,
+                      std::vector<Vector<double> >                             &pressure,
+                      std::vector<Vector<double> >                             &enthalpy,
+                      std::vector<std::vector<std::vector<Vector<double> > > > &fluxes) const
+{
+  const std::vector<Vector<double> > &density = solution[0];
+  const std::vector<Vector<double> > &energy = solution[dim+1];
+
+  // time derivatives of 1/rho from those of rho*(1/rho)=1
+  if (n == 0)
+    reciprocal (density[0], inverse_density[0]);
+  else
+    {
+      Vector<double> sum (fe->dofs_per_cell);
+      add_leibniz_terms (density, inverse_density, n, 1, 1., sum);
+      fe->multiply (inverse_density[0], sum, inverse_density[n]);
+      inverse_density[n] *= -1.;
+    }
+
+  // velocity m/rho and pressure (gamma-1)(E-m.v/2)
+  pressure[n] = energy[n];
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      add_leibniz_terms (solution[1+d], inverse_density, n, 0, 1., velocity[d][n]);
+      add_leibniz_terms (solution[1+d], velocity[d], n, 0, -0.5, pressure[n]);
+    }
+  pressure[n] *= (gamma-1.);
+  enthalpy[n] = energy[n];
+  enthalpy[n] += pressure[n];
+
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      fluxes[0][d][n] = solution[1+d][n];
+      for (unsigned int e=0; e<dim; ++e)
+        add_leibniz_terms (solution[1+e], velocity[d], n, 0, 1., fluxes[1+e][d][n]);
+      fluxes[1+d][d][n] += pressure[n];
+      add_leibniz_terms (enthalpy, velocity[d], n, 0, 1., fluxes[dim+1][d][n]);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+add_leibniz_terms (const std::vector<Vector<double> > &a,
+                   const std::vector<Vector<double> > &b,
+                   const unsigned int                  n,
+                   const unsigned int                  first,
+                   const double                        factor,
+                   Vector<double>                     &result) const
+{
+  Vector<double> product (fe->dofs_per_cell);
+  for (unsigned int j=first; j<=n; ++j)
+    {
+      fe->multiply (a[j], b[n-j], product);
+      result.add (factor * binomials(n,j), product);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+add_derivative (const Vector<double> &f,
+                const unsigned int    d,
+                const double          h,
+                const double          factor,
+                Vector<double>       &result) const
+{
+  // the derivative of the monomial with exponents alpha+e_d in direction d
+  // is (alpha_d+1)/h times the monomial with exponents alpha
+  const Table<2,unsigned int> &exponents = fe->get_monomial_exponents();
+  for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+    if (raise_indices(i,d) != numbers::invalid_unsigned_int)
+      result(i) += factor * (exponents(i,d)+1) / h * f(raise_indices(i,d));
+}
+
+
+
+template <int dim, int spacedim>
+void
+ADERPredictor<dim,spacedim>::
+reciprocal (const Vector<double> &a,
+            Vector<double>       &result) const
+{
+  AssertThrow (a(0) > 0,
+               ExcMessage ("The density must be positive at the center of each cell."));
+
+  // with a = a_0 (1+r), where r vanishes at the center, 1/a is
+  // 1/a_0 sum_m (-r)^m, and the powers of r beyond the degree of the
+  // element vanish after truncation
+  Vector<double> r (a);
+  r /= a(0);
+  r(0) = 0;
+
+  Vector<double> tmp (fe->dofs_per_cell);
+  result = 0;
+  result(0) = 1.;
+  for (unsigned int m=0; m<fe->degree; ++m)
+    {
+      fe->multiply (r, result, tmp);
+      result = 0;
+      result(0) = 1.;
+      result -= tmp;
+    }
+  result /= a(0);
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_ader_predictor.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
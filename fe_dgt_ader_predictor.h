@@ -0,0 +1,245 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_ader_predictor_h
+#define dealii__fe_dgt_ader_predictor_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A Cauchy-Kovalevskaya predictor for ADER discontinuous Galerkin schemes
+ * with the FE_DGT element, for linear advection with a constant velocity
+ * and for the compressible Euler equations.
+ *
+ * For a conservation law $\partial_t u + \nabla\cdot f(u) = 0$, the time
+ * derivatives of the solution follow from the spatial ones by the
+ * recursion
+ * @f[
+ *   \partial_t^{n+1} u = -\sum_d \partial_d \, \partial_t^n f_d(u).
+ * @f]
+ * Since the coefficients of FE_DGT are scaled derivatives at the center
+ * of a cell, both the spatial derivatives and the products in the flux can
+ * be formed on the coefficients directly, see FE_DGT::multiply(). The time
+ * derivatives of the nonlinear Euler fluxes are obtained from those of the
+ * conserved variables by the Leibniz rule, and the division by the density
+ * by the truncated Taylor series of the reciprocal. Each time derivative
+ * lowers the degree of accuracy in space by one, so the recursion stops
+ * after as many steps as the degree of the element.
+ *
+ * predict() returns the solution and the fluxes averaged over a time step.
+ * Inserting them into the volume and face terms of the discontinuous
+ * Galerkin discretization gives a one-step scheme of the same order in time
+ * as in space, with a single exchange of face data per time step instead
+ * of one per stage of a Runge-Kutta method. The volume terms can be formed
+ * by FE_DGT::integrate_against_shape_gradients() from the averaged fluxes.
+ *
+ * Solutions with several components are passed as one vector of
+ * coefficients per component, in the order density, momentum, energy for
+ * the Euler equations.
+ */
+template <int dim, int spacedim=dim>
+class ADERPredictor : public Subscriptor
+{
+public:
+  /**
+   * The equations the predictor can be used for.
+   */
+  enum Equation
+  {
+    /**
+     * $\partial_t u + a\cdot\nabla u = 0$ with a constant velocity $a$.
+     */
+    linear_advection,
+    /**
+     * The compressible Euler equations of an ideal gas.
+     */
+    euler
+  };
+
+  /**
+   * Constructor for linear advection with the given velocity.
+   */
+  ADERPredictor (const FE_DGT<dim,spacedim> &fe,
+                 const Tensor<1,dim>        &advection_velocity);
+
+  /**
+   * Constructor for the Euler equations of an ideal gas with the ratio of
+   * specific heats @p gamma.
+   */
+  ADERPredictor (const FE_DGT<dim,spacedim> &fe,
+                 const double                gamma);
+
+  /**
+   * Return the number of solution components, i.e., one for linear
+   * advection and <tt>dim+2</tt> for the Euler equations.
+   */
+  unsigned int n_components () const;
+
+  /**
+   * Compute the coefficients of the time derivatives of the solution with
+   * coefficients @p coefficients on @p cell. On return,
+   * <tt>time_derivatives[c][n]</tt> holds the time derivative of order
+   * @p n of component @p c, for $n=0,\dots,k$ with $k$ the degree of the
+   * element.
+   */
+  void
+  compute_time_derivatives (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                            const std::vector<Vector<double> >         &coefficients,
+                            std::vector<std::vector<Vector<double> > > &time_derivatives) const;
+
+  /**
+   * Compute the averages over the time interval $[t,t+\Delta t]$ of the
+   * solution and of the fluxes on @p cell, where @p coefficients describe
+   * the solution at time $t$. <tt>averaged_flux[c][d]</tt> is the flux of
+   * component @p c in direction @p d.
+   */
+  void
+  predict (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+           const std::vector<Vector<double> >         &coefficients,
+           const double                                time_step,
+           std::vector<Vector<double> >               &averaged_solution,
+           std::vector<std::vector<Vector<double> > > &averaged_flux) const;
+
+  /**
+   * Evaluate the Taylor expansion in time of the solution on @p cell at
+   * time $t+\tau$, where @p coefficients describe the solution at time
+   * $t$.
+   */
+  void
+  evaluate_in_time (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                    const std::vector<Vector<double> > &coefficients,
+                    const double                        tau,
+                    std::vector<Vector<double> >       &solution) const;
+
+private:
+  /**
+   * Set up #raise_indices and #binomials.
+   */
+  void initialize ();
+
+  /**
+   * Compute the time derivatives of the solution and of the fluxes on
+   * @p cell. <tt>fluxes[c][d][n]</tt> is the time derivative of order @p n
+   * of the flux of component @p c in direction @p d.
+   */
+  void
+  compute_series (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                  const std::vector<Vector<double> >                      &coefficients,
+                  std::vector<std::vector<Vector<double> > >              &solution,
+                  std::vector<std::vector<std::vector<Vector<double> > > > &fluxes) const;
+
+  /**
+   * Compute the time derivative of order @p n of the Euler fluxes, given
+   * the time derivatives up to order @p n of the solution. The series of
+   * the inverse density, the velocity and the pressure are extended by one
+   * order.
+   */
+  void
+  compute_euler_fluxes (const unsigned int                                        n,
+                        const std::vector<std::vector<Vector<double> > >         &solution,
+                        std::vector<Vector<double> >                             &inverse_density,
+                        std::vector<std::vector<Vector<double> > >               &velocity,
+                        std::vector<Vector<double> >                             &pressure,
+                        std::vector<Vector<double> >                             &enthalpy,
+                        std::vector<std::vector<std::vector<Vector<double> > > > &fluxes) const;
+
+  /**
+   * Add <tt>factor</tt> times the sum over <tt>j=first,...,n</tt> of
+   * $\binom{n}{j} a_j b_{n-j}$ to @p result, i.e., the terms of the
+   * Leibniz rule for the time derivative of order @p n of a product.
+   */
+  void
+  add_leibniz_terms (const std::vector<Vector<double> > &a,
+                     const std::vector<Vector<double> > &b,
+                     const unsigned int                  n,
+                     const unsigned int                  first,
+                     const double                        factor,
+                     Vector<double>                     &result) const;
+
+  /**
+   * Add <tt>factor</tt> times the derivative in direction @p d of the
+   * function with coefficients @p f on a cell of diameter @p h to
+   * @p result.
+   */
+  void
+  add_derivative (const Vector<double> &f,
+                  const unsigned int    d,
+                  const double          h,
+                  const double          factor,
+                  Vector<double>       &result) const;
+
+  /**
+   * Compute the coefficients of $1/a$, truncated to the degree of the
+   * element, from those of $a$, whose value at the center of the cell must
+   * be positive.
+   */
+  void
+  reciprocal (const Vector<double> &a,
+              Vector<double>       &result) const;
+
+  /**
+   * The element.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,ADERPredictor<dim,spacedim> > fe;
+
+  /**
+   * The equation.
+   */
+  const Equation equation;
+
+  /**
+   * The advection velocity for linear advection.
+   */
+  const Tensor<1,dim> advection_velocity;
+
+  /**
+   * The ratio of specific heats for the Euler equations.
+   */
+  const double gamma;
+
+  /**
+   * The index of the shape function whose exponent in direction @p d is
+   * one larger than that of shape function @p i, or
+   * numbers::invalid_unsigned_int if its degree exceeds the degree of the
+   * element.
+   */
+  Table<2,unsigned int> raise_indices;
+
+  /**
+   * The binomial coefficients $\binom{n}{j}$ for $n$ up to the degree of
+   * the element.
+   */
+  Table<2,double> binomials;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
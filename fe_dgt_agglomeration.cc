@@ -0,0 +1,525 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_dgt_agglomeration.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+Agglomeration<dim,spacedim>::
+Agglomeration (const DoFHandler<dim,spacedim> &dof_handler,
+               const Quadrature<dim>          &quadrature)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  fe (dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe()),
+      typeid(*this).name()),
+  quadrature (quadrature)
+{
+  AssertThrow (fe != 0 && fe->n_components() == 1,
+               ExcMessage ("Agglomeration requires a scalar FE_DGT element."));
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::reinit (const std::vector<unsigned int> &agglomerate_indices)
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+  const unsigned int n_cells = connectivity.n_cells();
+  AssertDimension (agglomerate_indices.size(), n_cells);
+  cell_agglomerates = agglomerate_indices;
+
+  const unsigned int n_agglomerates
+    = (n_cells > 0 ? *std::max_element (cell_agglomerates.begin(), cell_agglomerates.end()) + 1 : 0);
+  agglomerates.clear ();
+  agglomerates.resize (n_agglomerates);
+  for (unsigned int c=0; c<n_cells; ++c)
+    agglomerates[cell_agglomerates[c]].cells.push_back (c);
+  for (unsigned int a=0; a<n_agglomerates; ++a)
+    AssertThrow (agglomerates[a].cells.size() > 0,
+                 ExcMessage ("The agglomerate indices must be consecutive."));
+
+  cell_prolongation.resize (n_cells);
+  parallel::apply_to_subranges (0U, n_agglomerates,
+                                std_cxx11::bind (&Agglomeration<dim,spacedim>::initialize_agglomerates,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::reinit_from_level (const unsigned int level)
+{
+  // number the agglomerates in the order in which the active cells first
+  // reach them
+  std::vector<unsigned int> assignment (dof_handler->get_triangulation().n_active_cells());
+  std::map<std::pair<int,int>, unsigned int> ancestors;
+  for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+       cell = dof_handler->begin_active(); cell != dof_handler->end(); ++cell)
+    {
+      typename DoFHandler<dim,spacedim>::cell_iterator ancestor = cell;
+      while (ancestor->level() > static_cast<int>(level))
+        ancestor = ancestor->parent();
+
+      const std::pair<int,int> key (ancestor->level(), ancestor->index());
+      std::map<std::pair<int,int>, unsigned int>::const_iterator entry = ancestors.find (key);
+      if (entry == ancestors.end())
+        {
+          const unsigned int index = ancestors.size();
+          entry = ancestors.insert (std::make_pair (key, index)).first;
+        }
+      assignment[cell->active_cell_index()] = entry->second;
+    }
+
+  reinit (assignment);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+initialize_agglomerates (const unsigned int begin,
+                         const unsigned int end)
+{
+  FEValues<dim,spacedim> fe_values (*fe, quadrature,
+                                    update_quadrature_points | update_JxW_values);
+  const Table<2,unsigned int> &exponents = fe->get_monomial_exponents();
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+
+  for (unsigned int a=begin; a<end; ++a)
+    {
+      AgglomerateData &data = agglomerates[a];
+      data.quadrature_points.clear ();
+      data.JxW.clear ();
+
+      // the union of the quadrature rules of the cells, and the bounding
+      // box of their vertices
+      Point<spacedim> lower = connectivity.cells[data.cells[0]]->vertex(0);
+      Point<spacedim> upper = lower;
+      for (unsigned int k=0; k<data.cells.size(); ++k)
+        {
+          const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+            = connectivity.cells[data.cells[k]];
+          fe_values.reinit (cell);
+          for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+            {
+              data.quadrature_points.push_back (fe_values.quadrature_point(q));
+              data.JxW.push_back (fe_values.JxW(q));
+            }
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                lower[d] = std::min (lower[d], cell->vertex(v)[d]);
+                upper[d] = std::max (upper[d], cell->vertex(v)[d]);
+              }
+        }
+
+      const unsigned int n_points = data.JxW.size();
+      data.measure = 0;
+      data.center = Point<spacedim>();
+      for (unsigned int q=0; q<n_points; ++q)
+        {
+          data.measure += data.JxW[q];
+          data.center += data.JxW[q] * data.quadrature_points[q];
+        }
+      data.center /= data.measure;
+      data.diameter = lower.distance (upper);
+
+      data.shape_values.reinit (dofs_per_cell, n_points);
+      for (unsigned int q=0; q<n_points; ++q)
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            double value = 1.;
+            for (unsigned int d=0; d<dim; ++d)
+              value *= std::pow ((data.quadrature_points[q][d] - data.center[d]) / data.diameter,
+                                 static_cast<int>(exponents(i,d)));
+            data.shape_values(i,q) = value;
+          }
+
+      data.mass_matrix.reinit (dofs_per_cell, dofs_per_cell);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int j=0; j<=i; ++j)
+          {
+            double entry = 0;
+            for (unsigned int q=0; q<n_points; ++q)
+              entry += data.shape_values(i,q) * data.shape_values(j,q) * data.JxW[q];
+            data.mass_matrix(i,j) = data.mass_matrix(j,i) = entry;
+          }
+      data.inverse_mass_matrix = data.mass_matrix;
+      data.inverse_mass_matrix.gauss_jordan ();
+
+      // the polynomials of the agglomerate are polynomials on each cell
+      for (unsigned int k=0; k<data.cells.size(); ++k)
+        {
+          const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+            = connectivity.cells[data.cells[k]];
+          fe->get_reexpansion_matrix (data.center, data.diameter,
+                                      cell->center(), cell->diameter(),
+                                      cell_prolongation[data.cells[k]]);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+Agglomeration<dim,spacedim>::n_agglomerates () const
+{
+  return agglomerates.size();
+}
+
+
+
+template <int dim, int spacedim>
+types::global_dof_index
+Agglomeration<dim,spacedim>::n_dofs () const
+{
+  return static_cast<types::global_dof_index>(agglomerates.size()) * fe->dofs_per_cell;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+Agglomeration<dim,spacedim>::agglomerate_of_cell (const unsigned int cell) const
+{
+  AssertIndexRange (cell, cell_agglomerates.size());
+  return cell_agglomerates[cell];
+}
+
+
+
+template <int dim, int spacedim>
+const std::vector<unsigned int> &
+Agglomeration<dim,spacedim>::get_cells (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].cells;
+}
+
+
+
+template <int dim, int spacedim>
+const Point<spacedim> &
+Agglomeration<dim,spacedim>::center (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].center;
+}
+
+
+
+template <int dim, int spacedim>
+double
+Agglomeration<dim,spacedim>::diameter (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].diameter;
+}
+
+
+
+template <int dim, int spacedim>
+double
+Agglomeration<dim,spacedim>::measure (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].measure;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+Agglomeration<dim,spacedim>::n_quadrature_points (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].JxW.size();
+}
+
+
+
+template <int dim, int spacedim>
+const Point<spacedim> &
+Agglomeration<dim,spacedim>::quadrature_point (const unsigned int a,
+                                               const unsigned int q) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  AssertIndexRange (q, agglomerates[a].quadrature_points.size());
+  return agglomerates[a].quadrature_points[q];
+}
+
+
+
+template <int dim, int spacedim>
+double
+Agglomeration<dim,spacedim>::JxW (const unsigned int a,
+                                  const unsigned int q) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  AssertIndexRange (q, agglomerates[a].JxW.size());
+  return agglomerates[a].JxW[q];
+}
+
+
+
+template <int dim, int spacedim>
+double
+Agglomeration<dim,spacedim>::shape_value (const unsigned int a,
+                                          const unsigned int i,
+                                          const unsigned int q) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].shape_values(i,q);
+}
+
+
+
+template <int dim, int spacedim>
+const FullMatrix<double> &
+Agglomeration<dim,spacedim>::get_mass_matrix (const unsigned int a) const
+{
+  AssertIndexRange (a, agglomerates.size());
+  return agglomerates[a].mass_matrix;
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+prolongate (const Vector<double> &coarse,
+            Vector<double>       &fine) const
+{
+  AssertDimension (coarse.size(), n_dofs());
+  AssertDimension (fine.size(), dof_handler->n_dofs());
+  parallel::apply_to_subranges (0U, n_agglomerates(),
+                                std_cxx11::bind (&Agglomeration<dim,spacedim>::prolongate_agglomerates,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (coarse),
+                                                 std_cxx11::ref (fine)),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+restrict_residual (const Vector<double> &fine,
+                   Vector<double>       &coarse) const
+{
+  AssertDimension (coarse.size(), n_dofs());
+  AssertDimension (fine.size(), dof_handler->n_dofs());
+  parallel::apply_to_subranges (0U, n_agglomerates(),
+                                std_cxx11::bind (&Agglomeration<dim,spacedim>::restrict_agglomerates,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (fine),
+                                                 std_cxx11::ref (coarse),
+                                                 false),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+project (const Vector<double> &fine,
+         Vector<double>       &coarse) const
+{
+  AssertDimension (coarse.size(), n_dofs());
+  AssertDimension (fine.size(), dof_handler->n_dofs());
+  parallel::apply_to_subranges (0U, n_agglomerates(),
+                                std_cxx11::bind (&Agglomeration<dim,spacedim>::restrict_agglomerates,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (fine),
+                                                 std_cxx11::ref (coarse),
+                                                 true),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+prolongate_agglomerates (const unsigned int    begin,
+                         const unsigned int    end,
+                         const Vector<double> &coarse,
+                         Vector<double>       &fine) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  Vector<double> coarse_values (dofs_per_cell);
+  Vector<double> fine_values (dofs_per_cell);
+  for (unsigned int a=begin; a<end; ++a)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        coarse_values(i) = coarse(a*dofs_per_cell+i);
+      for (unsigned int k=0; k<agglomerates[a].cells.size(); ++k)
+        {
+          const unsigned int c = agglomerates[a].cells[k];
+          cell_prolongation[c].vmult (fine_values, coarse_values);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            fine(connectivity.dof_indices(c,i)) = fine_values(i);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+restrict_agglomerates (const unsigned int    begin,
+                       const unsigned int    end,
+                       const Vector<double> &fine,
+                       Vector<double>       &coarse,
+                       const bool            l2_projection) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  Vector<double> coarse_values (dofs_per_cell);
+  Vector<double> fine_values (dofs_per_cell);
+  Vector<double> weighted_values (dofs_per_cell);
+  Vector<double> projection (dofs_per_cell);
+  FullMatrix<double> mass_matrix;
+  for (unsigned int a=begin; a<end; ++a)
+    {
+      // for the projection, sum the integrals of the fine function against
+      // the coarse shape functions, P_c^T M_c u_c, over the cells
+      coarse_values = 0;
+      for (unsigned int k=0; k<agglomerates[a].cells.size(); ++k)
+        {
+          const unsigned int c = agglomerates[a].cells[k];
+          connectivity.get_coefficients (fine, c, fine_values);
+          if (l2_projection)
+            {
+              fe->get_mass_matrix (shape_classes, connectivity.cells[c], mass_matrix);
+              mass_matrix.vmult (weighted_values, fine_values);
+              cell_prolongation[c].Tvmult_add (coarse_values, weighted_values);
+            }
+          else
+            cell_prolongation[c].Tvmult_add (coarse_values, fine_values);
+        }
+
+      if (l2_projection)
+        {
+          agglomerates[a].inverse_mass_matrix.vmult (projection, coarse_values);
+          coarse_values = projection;
+        }
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        coarse(a*dofs_per_cell+i) = coarse_values(i);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+Agglomeration<dim,spacedim>::
+compute_coarse_matrix (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+                       FullMatrix<double>                        &coarse_matrix) const
+{
+  const unsigned int n = fe->dofs_per_cell;
+  AssertDimension (matrix.block_size(), n);
+  AssertDimension (matrix.n_block_rows(), connectivity.n_cells());
+  coarse_matrix.reinit (n_dofs(), n_dofs());
+
+  // add P_c^T A_cd P_d for each nonzero block of the cells c and d
+  FullMatrix<double> block (n, n), product (n, n), local_matrix (n, n);
+  std::vector<unsigned int> columns;
+  for (unsigned int c=0; c<connectivity.n_cells(); ++c)
+    {
+      columns.assign (connectivity.neighbors.begin() + connectivity.neighbor_start[c],
+                      connectivity.neighbors.begin() + connectivity.neighbor_start[c+1]);
+      columns.push_back (c);
+      std::sort (columns.begin(), columns.end());
+      columns.erase (std::unique (columns.begin(), columns.end()), columns.end());
+
+      for (unsigned int k=0; k<columns.size(); ++k)
+        {
+          const unsigned int d = columns[k];
+          const unsigned int index = matrix.block_index (c, d);
+          if (index == numbers::invalid_unsigned_int)
+            continue;
+
+          const double *entries = matrix.block (index);
+          for (unsigned int j=0; j<n; ++j)
+            for (unsigned int i=0; i<n; ++i)
+              block(i,j) = entries[j*n+i];
+          block.mmult (product, cell_prolongation[d]);
+          cell_prolongation[c].Tmmult (local_matrix, product);
+
+          const unsigned int row_offset = cell_agglomerates[c] * n;
+          const unsigned int column_offset = cell_agglomerates[d] * n;
+          for (unsigned int i=0; i<n; ++i)
+            for (unsigned int j=0; j<n; ++j)
+              coarse_matrix(row_offset+i, column_offset+j) += local_matrix(i,j);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+Agglomeration<dim,spacedim>::memory_consumption () const
+{
+  std::size_t memory = (MemoryConsumption::memory_consumption (connectivity.dof_indices) +
+                        MemoryConsumption::memory_consumption (connectivity.neighbor_start) +
+                        MemoryConsumption::memory_consumption (connectivity.neighbors) +
+                        MemoryConsumption::memory_consumption (cell_agglomerates) +
+                        MemoryConsumption::memory_consumption (cell_prolongation));
+  for (unsigned int a=0; a<agglomerates.size(); ++a)
+    memory += (MemoryConsumption::memory_consumption (agglomerates[a].cells) +
+               MemoryConsumption::memory_consumption (agglomerates[a].quadrature_points) +
+               MemoryConsumption::memory_consumption (agglomerates[a].JxW) +
+               MemoryConsumption::memory_consumption (agglomerates[a].shape_values) +
+               agglomerates[a].mass_matrix.memory_consumption() +
+               agglomerates[a].inverse_mass_matrix.memory_consumption());
+  return memory;
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_agglomeration.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
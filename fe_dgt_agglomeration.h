@@ -0,0 +1,293 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_agglomeration_h
+#define dealii__fe_dgt_agglomeration_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/table.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_block_sparse_matrix.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * Agglomerates of the active cells of a DoFHandler with the FE_DGT
+ * element, i.e., polygonal or polyhedral cells formed as unions of fine
+ * cells, with the FE_DGT basis of the same degree on each of them.
+ *
+ * The shape functions of FE_DGT are monomials of $(x-x_c)/h$, which only
+ * require a center $x_c$ and a length scale $h$ but no mapping from a
+ * reference cell, and are therefore defined on arbitrary agglomerates.
+ * The center of an agglomerate is its centroid and the length scale the
+ * diagonal of the bounding box of its vertices. Integrals over an
+ * agglomerate use the union of the quadrature rules of its fine cells,
+ * whose points, weights and shape function values are provided for
+ * assembling on the agglomerates, together with the mass matrix.
+ *
+ * The agglomerates form a coarse space without remeshing, e.g., for
+ * agglomeration multigrid or coarse-grid solves. The degrees of freedom
+ * of the coarse space are numbered by agglomerate, with index
+ * <tt>a*dofs_per_cell+i</tt> for shape function @p i of agglomerate
+ * @p a. Since a polynomial on an agglomerate is a polynomial on each of
+ * its cells, prolongation to the fine space is the exact re-expansion of
+ * FE_DGT::get_reexpansion_matrix() on each cell, whose matrices are
+ * computed by reinit(). The transpose restricts residuals, and
+ * compute_coarse_matrix() forms the Galerkin product with a
+ * CellBlockSparseMatrix.
+ */
+template <int dim, int spacedim=dim>
+class Agglomeration : public Subscriptor
+{
+public:
+  /**
+   * Constructor. The rule @p quadrature is applied on each fine cell; a
+   * Gauss rule with <tt>k+1</tt> points per direction computes the mass
+   * matrices exactly on affine cells.
+   */
+  Agglomeration (const DoFHandler<dim,spacedim> &dof_handler,
+                 const Quadrature<dim>          &quadrature);
+
+  /**
+   * Define the agglomerates by the index of the agglomerate of each
+   * active cell, indexed by active_cell_index(). The indices must be
+   * consecutive from zero, and each agglomerate should be connected.
+   * Must be called again whenever the mesh or the numbering of degrees of
+   * freedom changes.
+   */
+  void reinit (const std::vector<unsigned int> &agglomerate_indices);
+
+  /**
+   * Define the agglomerates as the unions of the active descendants of
+   * the cells on @p level of the triangulation. Active cells on coarser
+   * levels form agglomerates of their own.
+   */
+  void reinit_from_level (const unsigned int level);
+
+  /**
+   * Return the number of agglomerates.
+   */
+  unsigned int n_agglomerates () const;
+
+  /**
+   * Return the number of degrees of freedom of the coarse space.
+   */
+  types::global_dof_index n_dofs () const;
+
+  /**
+   * Return the agglomerate of the active cell with the given
+   * active_cell_index().
+   */
+  unsigned int agglomerate_of_cell (const unsigned int cell) const;
+
+  /**
+   * Return the active_cell_index() of the cells of agglomerate @p a.
+   */
+  const std::vector<unsigned int> &get_cells (const unsigned int a) const;
+
+  /**
+   * Return the center of agglomerate @p a.
+   */
+  const Point<spacedim> &center (const unsigned int a) const;
+
+  /**
+   * Return the length scale of agglomerate @p a.
+   */
+  double diameter (const unsigned int a) const;
+
+  /**
+   * Return the volume of agglomerate @p a.
+   */
+  double measure (const unsigned int a) const;
+
+  /**
+   * Return the number of quadrature points of agglomerate @p a, i.e., of
+   * all its cells.
+   */
+  unsigned int n_quadrature_points (const unsigned int a) const;
+
+  /**
+   * Return quadrature point @p q of agglomerate @p a.
+   */
+  const Point<spacedim> &quadrature_point (const unsigned int a,
+                                           const unsigned int q) const;
+
+  /**
+   * Return the product of the Jacobian determinant and the weight of
+   * quadrature point @p q of agglomerate @p a.
+   */
+  double JxW (const unsigned int a,
+              const unsigned int q) const;
+
+  /**
+   * Return the value of shape function @p i of agglomerate @p a at its
+   * quadrature point @p q.
+   */
+  double shape_value (const unsigned int a,
+                      const unsigned int i,
+                      const unsigned int q) const;
+
+  /**
+   * Return the mass matrix of agglomerate @p a.
+   */
+  const FullMatrix<double> &get_mass_matrix (const unsigned int a) const;
+
+  /**
+   * Compute the coefficients on the fine cells of the polynomials given by
+   * @p coarse on the agglomerates, in parallel over the agglomerates.
+   */
+  void prolongate (const Vector<double> &coarse,
+                   Vector<double>       &fine) const;
+
+  /**
+   * Apply the transpose of prolongate(), e.g., to restrict a residual.
+   */
+  void restrict_residual (const Vector<double> &fine,
+                          Vector<double>       &coarse) const;
+
+  /**
+   * Compute the $L^2$ projection of the fine space function @p fine onto
+   * the polynomials on the agglomerates.
+   */
+  void project (const Vector<double> &fine,
+                Vector<double>       &coarse) const;
+
+  /**
+   * Compute the Galerkin product $P^T A P$ of @p matrix with the
+   * prolongation. The coarse matrix is dense, which suits coarse problems
+   * of moderate size.
+   */
+  void compute_coarse_matrix (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+                              FullMatrix<double>                        &coarse_matrix) const;
+
+  /**
+   * Memory consumption in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The geometry, quadrature and cells of an agglomerate.
+   */
+  struct AgglomerateData
+  {
+    /**
+     * The active_cell_index() of the cells.
+     */
+    std::vector<unsigned int> cells;
+
+    /**
+     * The centroid, the diagonal of the bounding box, and the volume.
+     */
+    Point<spacedim> center;
+    double          diameter;
+    double          measure;
+
+    /**
+     * The quadrature points and weights of all cells, and the values of
+     * the shape functions, <tt>shape_values(i,q)</tt>.
+     */
+    std::vector<Point<spacedim> > quadrature_points;
+    std::vector<double>           JxW;
+    Table<2,double>               shape_values;
+
+    /**
+     * The mass matrix and its inverse.
+     */
+    FullMatrix<double> mass_matrix;
+    FullMatrix<double> inverse_mass_matrix;
+  };
+
+  /**
+   * Compute the data of the agglomerates <tt>[begin,end)</tt>.
+   */
+  void initialize_agglomerates (const unsigned int begin,
+                                const unsigned int end);
+
+  /**
+   * Work functions of prolongate(), restrict_residual() and project() on
+   * the agglomerates <tt>[begin,end)</tt>.
+   */
+  void prolongate_agglomerates (const unsigned int    begin,
+                                const unsigned int    end,
+                                const Vector<double> &coarse,
+                                Vector<double>       &fine) const;
+  void restrict_agglomerates (const unsigned int    begin,
+                              const unsigned int    end,
+                              const Vector<double> &fine,
+                              Vector<double>       &coarse,
+                              const bool            l2_projection) const;
+
+  /**
+   * The DoFHandler of the fine space.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,Agglomeration<dim,spacedim> > dof_handler;
+
+  /**
+   * The finite element.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,Agglomeration<dim,spacedim> > fe;
+
+  /**
+   * The quadrature rule on the fine cells.
+   */
+  const Quadrature<dim> quadrature;
+
+  /**
+   * The active cells, their degrees of freedom and face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+
+  /**
+   * The agglomerate of each active cell.
+   */
+  std::vector<unsigned int> cell_agglomerates;
+
+  /**
+   * The data of the agglomerates.
+   */
+  std::vector<AgglomerateData> agglomerates;
+
+  /**
+   * The prolongation matrix of each active cell, which re-expands the
+   * basis of its agglomerate in that of the cell.
+   */
+  std::vector<FullMatrix<double> > cell_prolongation;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
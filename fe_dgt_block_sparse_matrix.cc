@@ -0,0 +1,524 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt_block_sparse_matrix.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // y += A x for a dense block A of size n stored column by column
+  inline
+  void
+  block_vmult_add (const unsigned int  n,
+                   const double       *A,
+                   const double       *x,
+                   double             *y)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const double x_j = x[j];
+        const double *column = A + j*n;
+        DEAL_II_OPENMP_SIMD_PRAGMA
+        for (unsigned int i=0; i<n; ++i)
+          y[i] += column[i] * x_j;
+      }
+  }
+
+
+
+  // y -= A x for a dense block A of size n stored column by column
+  inline
+  void
+  block_vmult_subtract (const unsigned int  n,
+                        const double       *A,
+                        const double       *x,
+                        double             *y)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const double x_j = x[j];
+        const double *column = A + j*n;
+        DEAL_II_OPENMP_SIMD_PRAGMA
+        for (unsigned int i=0; i<n; ++i)
+          y[i] -= column[i] * x_j;
+      }
+  }
+
+
+
+  // C -= A B for dense blocks of size n stored column by column
+  inline
+  void
+  block_mmult_subtract (const unsigned int  n,
+                        const double       *A,
+                        const double       *B,
+                        double             *C)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      block_vmult_subtract (n, A, B + j*n, C + j*n);
+  }
+
+
+
+  // invert a dense block of size n stored column by column in place
+  void
+  invert_block (const unsigned int  n,
+                double             *A)
+  {
+    FullMatrix<double> matrix (n, n);
+    for (unsigned int j=0; j<n; ++j)
+      for (unsigned int i=0; i<n; ++i)
+        matrix(i,j) = A[j*n+i];
+    matrix.gauss_jordan ();
+    for (unsigned int j=0; j<n; ++j)
+      for (unsigned int i=0; i<n; ++i)
+        A[j*n+i] = matrix(i,j);
+  }
+}
+
+
+
+template <int dim, int spacedim>
+CellBlockSparseMatrix<dim,spacedim>::CellBlockSparseMatrix ()
+  :
+  n_dofs (0)
+{}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockSparseMatrix<dim,spacedim>::reinit (const DoFHandler<dim,spacedim> &dof_handler)
+{
+  connectivity.reinit (dof_handler);
+  n_dofs = dof_handler.n_dofs();
+
+  // the blocks of each row are the cell itself and its face neighbors,
+  // sorted and without duplicates
+  const unsigned int n_cells = connectivity.n_cells();
+  row_start.resize (n_cells+1);
+  diagonal_blocks.resize (n_cells);
+  column_cells.clear ();
+  std::vector<unsigned int> row;
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      row.assign (connectivity.neighbors.begin() + connectivity.neighbor_start[c],
+                  connectivity.neighbors.begin() + connectivity.neighbor_start[c+1]);
+      row.push_back (c);
+      std::sort (row.begin(), row.end());
+      row.erase (std::unique (row.begin(), row.end()), row.end());
+
+      row_start[c] = column_cells.size();
+      diagonal_blocks[c] = row_start[c] + (std::lower_bound (row.begin(), row.end(), c) - row.begin());
+      column_cells.insert (column_cells.end(), row.begin(), row.end());
+    }
+  row_start[n_cells] = column_cells.size();
+
+  const unsigned int size = block_size();
+  values.resize (0);
+  values.resize (column_cells.size() * size * size, 0.);
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockSparseMatrix<dim,spacedim>::
+reinit (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+        const std::vector<unsigned int>           &dofs)
+{
+  Assert (&matrix != this, ExcMessage ("The matrix must not be its own submatrix."));
+  const unsigned int n_cells = matrix.n_block_rows();
+  const unsigned int size = dofs.size();
+  const unsigned int source_size = matrix.block_size();
+  for (unsigned int i=0; i<size; ++i)
+    AssertIndexRange (dofs[i], source_size);
+
+  connectivity.cells = matrix.connectivity.cells;
+  connectivity.neighbor_start = matrix.connectivity.neighbor_start;
+  connectivity.neighbors = matrix.connectivity.neighbors;
+  connectivity.dof_indices.reinit (n_cells, size);
+  for (unsigned int c=0; c<n_cells; ++c)
+    for (unsigned int i=0; i<size; ++i)
+      connectivity.dof_indices(c,i) = c*size + i;
+  n_dofs = n_cells * size;
+
+  row_start = matrix.row_start;
+  column_cells = matrix.column_cells;
+  diagonal_blocks = matrix.diagonal_blocks;
+
+  values.resize (column_cells.size() * size * size);
+  for (unsigned int b=0; b<column_cells.size(); ++b)
+    {
+      const double *source = matrix.block (b);
+      double *entries = block (b);
+      for (unsigned int j=0; j<size; ++j)
+        for (unsigned int i=0; i<size; ++i)
+          entries[j*size+i] = source[dofs[j]*source_size+dofs[i]];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+types::global_dof_index
+CellBlockSparseMatrix<dim,spacedim>::m () const
+{
+  return n_dofs;
+}
+
+
+
+template <int dim, int spacedim>
+types::global_dof_index
+CellBlockSparseMatrix<dim,spacedim>::n () const
+{
+  return n_dofs;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+CellBlockSparseMatrix<dim,spacedim>::block_size () const
+{
+  return connectivity.dof_indices.size(1);
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+CellBlockSparseMatrix<dim,spacedim>::n_block_rows () const
+{
+  return connectivity.n_cells();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+CellBlockSparseMatrix<dim,spacedim>::n_blocks () const
+{
+  return column_cells.size();
+}
+
+
+
+template <int dim, int spacedim>
+CellBlockSparseMatrix<dim,spacedim> &
+CellBlockSparseMatrix<dim,spacedim>::operator = (const double d)
+{
+  Assert (d == 0, ExcMessage ("Only zero can be assigned to the matrix."));
+  (void)d;
+  std::fill (values.begin(), values.end(), 0.);
+  return *this;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+CellBlockSparseMatrix<dim,spacedim>::
+block_index (const unsigned int row_cell,
+             const unsigned int column_cell) const
+{
+  AssertIndexRange (row_cell, n_block_rows());
+  const std::vector<unsigned int>::const_iterator
+  begin = column_cells.begin() + row_start[row_cell],
+  end = column_cells.begin() + row_start[row_cell+1],
+  position = std::lower_bound (begin, end, column_cell);
+  if (position == end || *position != column_cell)
+    return numbers::invalid_unsigned_int;
+  return position - column_cells.begin();
+}
+
+
+
+template <int dim, int spacedim>
+double *
+CellBlockSparseMatrix<dim,spacedim>::block (const unsigned int index)
+{
+  AssertIndexRange (index, n_blocks());
+  return values.begin() + index * block_size() * block_size();
+}
+
+
+
+template <int dim, int spacedim>
+const double *
+CellBlockSparseMatrix<dim,spacedim>::block (const unsigned int index) const
+{
+  AssertIndexRange (index, n_blocks());
+  return values.begin() + index * block_size() * block_size();
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockSparseMatrix<dim,spacedim>::
+add (const unsigned int        row_cell,
+     const unsigned int        column_cell,
+     const FullMatrix<double> &local_matrix)
+{
+  const unsigned int size = block_size();
+  AssertDimension (local_matrix.m(), size);
+  AssertDimension (local_matrix.n(), size);
+
+  const unsigned int index = block_index (row_cell, column_cell);
+  Assert (index != numbers::invalid_unsigned_int,
+          ExcMessage ("The cells are not face neighbors."));
+
+  double *entries = block (index);
+  for (unsigned int j=0; j<size; ++j)
+    for (unsigned int i=0; i<size; ++i)
+      entries[j*size+i] += local_matrix(i,j);
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockSparseMatrix<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  parallel::apply_to_subranges (0U, n_block_rows(),
+                                std_cxx11::bind (&CellBlockSparseMatrix<dim,spacedim>::vmult_rows,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockSparseMatrix<dim,spacedim>::
+vmult_rows (const unsigned int    begin,
+            const unsigned int    end,
+            Vector<double>       &dst,
+            const Vector<double> &src) const
+{
+  const unsigned int size = block_size();
+  std::vector<double> x (size);
+  std::vector<double> y (size);
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      std::fill (y.begin(), y.end(), 0.);
+      for (unsigned int b=row_start[c]; b<row_start[c+1]; ++b)
+        {
+          const unsigned int column_cell = column_cells[b];
+          for (unsigned int j=0; j<size; ++j)
+            x[j] = src(connectivity.dof_indices(column_cell,j));
+          block_vmult_add (size, block(b), &x[0], &y[0]);
+        }
+      for (unsigned int i=0; i<size; ++i)
+        dst(connectivity.dof_indices(c,i)) = y[i];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+CellBlockSparseMatrix<dim,spacedim>::memory_consumption () const
+{
+  return (MemoryConsumption::memory_consumption (connectivity.dof_indices) +
+          MemoryConsumption::memory_consumption (row_start) +
+          MemoryConsumption::memory_consumption (column_cells) +
+          MemoryConsumption::memory_consumption (diagonal_blocks) +
+          values.memory_consumption());
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockJacobi<dim,spacedim>::initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix)
+{
+  this->matrix = &matrix;
+
+  const unsigned int size = matrix.block_size();
+  inverse_diagonal.resize (matrix.n_block_rows() * size * size);
+  for (unsigned int c=0; c<matrix.n_block_rows(); ++c)
+    {
+      std::copy (matrix.block (matrix.diagonal_blocks[c]),
+                 matrix.block (matrix.diagonal_blocks[c]) + size*size,
+                 inverse_diagonal.begin() + c*size*size);
+      invert_block (size, inverse_diagonal.begin() + c*size*size);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockJacobi<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), matrix->m());
+  AssertDimension (src.size(), matrix->n());
+  parallel::apply_to_subranges (0U, matrix->n_block_rows(),
+                                std_cxx11::bind (&CellBlockJacobi<dim,spacedim>::vmult_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockJacobi<dim,spacedim>::
+vmult_cells (const unsigned int    begin,
+             const unsigned int    end,
+             Vector<double>       &dst,
+             const Vector<double> &src) const
+{
+  const unsigned int size = matrix->block_size();
+  const Table<2,types::global_dof_index> &dof_indices = matrix->connectivity.dof_indices;
+  std::vector<double> x (size);
+  std::vector<double> y (size);
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      for (unsigned int j=0; j<size; ++j)
+        x[j] = src(dof_indices(c,j));
+      std::fill (y.begin(), y.end(), 0.);
+      block_vmult_add (size, inverse_diagonal.begin() + c*size*size, &x[0], &y[0]);
+      for (unsigned int i=0; i<size; ++i)
+        dst(dof_indices(c,i)) = y[i];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockILU<dim,spacedim>::initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix)
+{
+  this->matrix = &matrix;
+  values = matrix.values;
+
+  const unsigned int size = matrix.block_size();
+  const unsigned int block_entries = size*size;
+  std::vector<double> tmp (block_entries);
+
+  for (unsigned int i=0; i<matrix.n_block_rows(); ++i)
+    {
+      // eliminate the blocks left of the diagonal. the diagonal blocks of
+      // the rows above already hold the inverses of those of U
+      for (unsigned int e=matrix.row_start[i]; e<matrix.diagonal_blocks[i]; ++e)
+        {
+          const unsigned int k = matrix.column_cells[e];
+          double *L_ik = values.begin() + e*block_entries;
+
+          // L_ik = A_ik U_kk^{-1}
+          std::fill (tmp.begin(), tmp.end(), 0.);
+          for (unsigned int j=0; j<size; ++j)
+            block_vmult_add (size, L_ik,
+                             values.begin() + matrix.diagonal_blocks[k]*block_entries + j*size,
+                             &tmp[j*size]);
+          std::copy (tmp.begin(), tmp.end(), L_ik);
+
+          // A_ij -= L_ik U_kj for the blocks j>k present in both rows
+          for (unsigned int f=e+1; f<matrix.row_start[i+1]; ++f)
+            {
+              const unsigned int g = matrix.block_index (k, matrix.column_cells[f]);
+              if (g != numbers::invalid_unsigned_int)
+                block_mmult_subtract (size, L_ik, values.begin() + g*block_entries,
+                                      values.begin() + f*block_entries);
+            }
+        }
+
+      invert_block (size, values.begin() + matrix.diagonal_blocks[i]*block_entries);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellBlockILU<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), matrix->m());
+  AssertDimension (src.size(), matrix->n());
+
+  const unsigned int size = matrix->block_size();
+  const unsigned int block_entries = size*size;
+  const unsigned int n_rows = matrix->n_block_rows();
+  const Table<2,types::global_dof_index> &dof_indices = matrix->connectivity.dof_indices;
+
+  // forward substitution with L, whose diagonal blocks are identities. the
+  // solution is kept in the order of the cells
+  std::vector<double> y (n_rows * size);
+  for (unsigned int i=0; i<n_rows; ++i)
+    {
+      double *y_i = &y[i*size];
+      for (unsigned int k=0; k<size; ++k)
+        y_i[k] = src(dof_indices(i,k));
+      for (unsigned int e=matrix->row_start[i]; e<matrix->diagonal_blocks[i]; ++e)
+        block_vmult_subtract (size, values.begin() + e*block_entries,
+                              &y[matrix->column_cells[e]*size], y_i);
+    }
+
+  // backward substitution with U
+  std::vector<double> tmp (size);
+  for (unsigned int i=n_rows; i>0; )
+    {
+      --i;
+      std::copy (&y[i*size], &y[i*size]+size, tmp.begin());
+      for (unsigned int e=matrix->diagonal_blocks[i]+1; e<matrix->row_start[i+1]; ++e)
+        block_vmult_subtract (size, values.begin() + e*block_entries,
+                              &y[matrix->column_cells[e]*size], &tmp[0]);
+      std::fill (&y[i*size], &y[i*size]+size, 0.);
+      block_vmult_add (size, values.begin() + matrix->diagonal_blocks[i]*block_entries,
+                       &tmp[0], &y[i*size]);
+    }
+
+  for (unsigned int i=0; i<n_rows; ++i)
+    for (unsigned int k=0; k<size; ++k)
+      dst(dof_indices(i,k)) = y[i*size+k];
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_block_sparse_matrix.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,281 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_block_sparse_matrix_h
+#define dealii__fe_dgt_block_sparse_matrix_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A sparse matrix for discontinuous Galerkin discretizations, e.g., with
+ * the FE_DGT element, stored in block compressed row format with one dense
+ * block of size <tt>dofs_per_cell</tt> for each pair of a cell and itself
+ * or one of its face neighbors.
+ *
+ * Compared to SparseMatrix with the flux sparsity pattern, only one column
+ * index is stored per block instead of per entry, and matrix-vector
+ * products run over contiguous dense blocks. The blocks of a row are
+ * sorted by the active_cell_index() of the column cell, and each block is
+ * stored column by column, so that the product of a block with a vector is
+ * a sequence of vectorizable updates with contiguous columns. Rows and
+ * columns of a block are numbered like the degrees of freedom of the cell,
+ * which are mapped to the global numbering of the DoFHandler when vectors
+ * are accessed.
+ *
+ * Local matrices of cells and faces are added with add(). The
+ * preconditioners CellBlockJacobi and CellBlockILU operate on whole
+ * blocks.
+ */
+template <int dim, int spacedim=dim>
+class CellBlockSparseMatrix : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Leaves the matrix empty.
+   */
+  CellBlockSparseMatrix ();
+
+  /**
+   * Set up the block sparsity pattern of the cells of @p dof_handler and
+   * their face neighbors and set all entries to zero.
+   */
+  void reinit (const DoFHandler<dim,spacedim> &dof_handler);
+
+  /**
+   * Set this matrix to the submatrix of @p matrix formed by the rows and
+   * columns of the degrees of freedom with the given indices
+   * <tt>dofs</tt> within each cell, with the same block sparsity pattern.
+   * The degrees of freedom of this matrix are numbered cell by cell, with
+   * index <tt>c*dofs.size()+i</tt> for the @p i th selected degree of
+   * freedom of the cell with active_cell_index() @p c. For the
+   * hierarchical FE_DGT element, the submatrix of the shape functions of
+   * degree at most $l$ is the Galerkin projection onto FE_DGT($l$).
+   */
+  void reinit (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+               const std::vector<unsigned int>           &dofs);
+
+  /**
+   * Return the number of rows, i.e., the number of degrees of freedom.
+   */
+  types::global_dof_index m () const;
+
+  /**
+   * Return the number of columns, i.e., the number of degrees of freedom.
+   */
+  types::global_dof_index n () const;
+
+  /**
+   * Return the size of the blocks, i.e., the number of degrees of freedom
+   * per cell.
+   */
+  unsigned int block_size () const;
+
+  /**
+   * Return the number of cells, i.e., of block rows.
+   */
+  unsigned int n_block_rows () const;
+
+  /**
+   * Return the number of nonzero blocks.
+   */
+  unsigned int n_blocks () const;
+
+  /**
+   * Set all entries to zero, keeping the sparsity pattern.
+   */
+  CellBlockSparseMatrix &operator = (const double d);
+
+  /**
+   * Add @p local_matrix to the block that couples the degrees of freedom
+   * of the cells with active_cell_index() @p row_cell and @p column_cell.
+   * The cells must be the same or face neighbors. Different threads may
+   * add to different block rows concurrently.
+   */
+  void add (const unsigned int        row_cell,
+            const unsigned int        column_cell,
+            const FullMatrix<double> &local_matrix);
+
+  /**
+   * Matrix-vector multiplication <tt>dst = M*src</tt>, parallel over the
+   * block rows.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+  /**
+   * Return the position of the block (@p row_cell, @p column_cell) in the
+   * list of blocks, or numbers::invalid_unsigned_int if it is not part of
+   * the sparsity pattern.
+   */
+  unsigned int block_index (const unsigned int row_cell,
+                            const unsigned int column_cell) const;
+
+  /**
+   * Return a pointer to the entries of the block with the given index,
+   * stored column by column.
+   */
+  double *block (const unsigned int index);
+
+  /**
+   * Constant version of the function above.
+   */
+  const double *block (const unsigned int index) const;
+
+  /**
+   * Memory consumption in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Compute the block rows <tt>[begin,end)</tt> of vmult().
+   */
+  void vmult_rows (const unsigned int    begin,
+                   const unsigned int    end,
+                   Vector<double>       &dst,
+                   const Vector<double> &src) const;
+
+  /**
+   * The cells and their degrees of freedom.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The number of degrees of freedom.
+   */
+  types::global_dof_index n_dofs;
+
+  /**
+   * The blocks of row @p c are <tt>row_start[c]</tt> up to
+   * <tt>row_start[c+1]-1</tt>, with column cells <tt>column_cells</tt>.
+   */
+  std::vector<unsigned int> row_start;
+  std::vector<unsigned int> column_cells;
+
+  /**
+   * The index of the diagonal block of each row.
+   */
+  std::vector<unsigned int> diagonal_blocks;
+
+  /**
+   * The entries of all blocks.
+   */
+  AlignedVector<double> values;
+
+  template <int, int> friend class CellBlockJacobi;
+  template <int, int> friend class CellBlockILU;
+  template <int, int> friend class PMultigrid;
+};
+
+
+
+/**
+ * Block Jacobi preconditioner for CellBlockSparseMatrix, i.e.,
+ * multiplication by the inverses of the diagonal blocks.
+ */
+template <int dim, int spacedim=dim>
+class CellBlockJacobi : public Subscriptor
+{
+public:
+  /**
+   * Invert the diagonal blocks of @p matrix.
+   */
+  void initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix);
+
+  /**
+   * Apply the preconditioner, in parallel over the cells.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+private:
+  /**
+   * Apply the inverses on the cells <tt>[begin,end)</tt>.
+   */
+  void vmult_cells (const unsigned int    begin,
+                    const unsigned int    end,
+                    Vector<double>       &dst,
+                    const Vector<double> &src) const;
+
+  /**
+   * The matrix.
+   */
+  SmartPointer<const CellBlockSparseMatrix<dim,spacedim>,CellBlockJacobi<dim,spacedim> > matrix;
+
+  /**
+   * The inverses of the diagonal blocks, stored column by column.
+   */
+  AlignedVector<double> inverse_diagonal;
+};
+
+
+
+/**
+ * Incomplete block LU decomposition without fill-in, ILU(0), for
+ * CellBlockSparseMatrix. The factorization is computed with dense block
+ * operations on the sparsity pattern of the matrix, storing the inverses
+ * of the diagonal blocks of $U$. Cells are eliminated in the order of
+ * their active_cell_index(). Application is sequential.
+ */
+template <int dim, int spacedim=dim>
+class CellBlockILU : public Subscriptor
+{
+public:
+  /**
+   * Compute the decomposition of @p matrix.
+   */
+  void initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix);
+
+  /**
+   * Apply the preconditioner, i.e., solve $LUx=b$ by forward and backward
+   * substitution.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+private:
+  /**
+   * The matrix, whose sparsity pattern is shared by the decomposition.
+   */
+  SmartPointer<const CellBlockSparseMatrix<dim,spacedim>,CellBlockILU<dim,spacedim> > matrix;
+
+  /**
+   * The blocks of the decomposition, with the strictly lower blocks of $L$
+   * (whose diagonal blocks are identities), the strictly upper blocks of
+   * $U$ and the inverses of the diagonal blocks of $U$.
+   */
+  AlignedVector<double> values;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
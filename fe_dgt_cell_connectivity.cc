@@ -0,0 +1,82 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace FE_DGTImplementation
+  {
+    template <int dim, int spacedim>
+    void
+    CellConnectivity<dim,spacedim>::reinit (const DoFHandler<dim,spacedim> &dof_handler)
+    {
+      const unsigned int n_cells = dof_handler.get_triangulation().n_active_cells();
+      const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+
+      cells.resize (n_cells);
+      dof_indices.reinit (n_cells, dofs_per_cell);
+      neighbor_start.resize (n_cells+1);
+      neighbors.clear ();
+
+      // collect the cells first, so that the neighbors can be entered in
+      // the order of the active cell index below
+      std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+      for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+           cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+        {
+          const unsigned int index = cell->active_cell_index();
+          cells[index] = cell;
+          cell->get_dof_indices (local_dof_indices);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            dof_indices(index,i) = local_dof_indices[i];
+        }
+
+      for (unsigned int c=0; c<n_cells; ++c)
+        {
+          neighbor_start[c] = neighbors.size();
+          const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell = cells[c];
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            {
+              if (cell->at_boundary(f))
+                continue;
+
+              if (cell->neighbor(f)->has_children())
+                for (unsigned int sf=0; sf<cell->face(f)->n_children(); ++sf)
+                  neighbors.push_back (cell->neighbor_child_on_subface(f,sf)->active_cell_index());
+              else
+                neighbors.push_back (cell->neighbor(f)->active_cell_index());
+            }
+        }
+      neighbor_start[n_cells] = neighbors.size();
+    }
+  }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_cell_connectivity.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_cell_connectivity_h
+#define dealii__fe_dgt_cell_connectivity_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/table.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace FE_DGTImplementation
+  {
+    /**
+     * The active cells of a DoFHandler, their degrees of freedom and their
+     * face neighbors, stored in flat arrays indexed by active_cell_index().
+     * This is the common setup of the algorithms for the FE_DGT element
+     * that operate on the coefficients of a cell and its neighbors only.
+     */
+    template <int dim, int spacedim>
+    class CellConnectivity
+    {
+    public:
+      /**
+       * Collect the data of all active cells of @p dof_handler. Must be
+       * called again whenever the mesh or the numbering of degrees of
+       * freedom changes.
+       */
+      void reinit (const DoFHandler<dim,spacedim> &dof_handler);
+
+      /**
+       * Number of active cells.
+       */
+      unsigned int n_cells () const;
+
+      /**
+       * Copy the coefficients of the cell with the given active_cell_index()
+       * from @p solution into @p coefficients.
+       */
+      void get_coefficients (const Vector<double> &solution,
+                             const unsigned int    cell,
+                             Vector<double>       &coefficients) const;
+
+      /**
+       * The active cells, indexed by their active_cell_index().
+       */
+      std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> cells;
+
+      /**
+       * The global indices of the degrees of freedom of each active cell.
+       */
+      Table<2,types::global_dof_index> dof_indices;
+
+      /**
+       * Connectivity table in compressed row format: the face neighbors of
+       * the cell with active_cell_index @p c are
+       * <tt>neighbors[neighbor_start[c]]</tt> up to
+       * <tt>neighbors[neighbor_start[c+1]-1]</tt>. On refined faces, all
+       * children adjacent to the face are neighbors.
+       */
+      std::vector<unsigned int> neighbor_start;
+      std::vector<unsigned int> neighbors;
+    };
+
+
+
+    template <int dim, int spacedim>
+    inline
+    unsigned int
+    CellConnectivity<dim,spacedim>::n_cells () const
+    {
+      return cells.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    void
+    CellConnectivity<dim,spacedim>::get_coefficients (const Vector<double> &solution,
+                                                      const unsigned int    cell,
+                                                      Vector<double>       &coefficients) const
+    {
+      AssertIndexRange (cell, cells.size());
+      AssertDimension (coefficients.size(), dof_indices.size(1));
+      for (unsigned int i=0; i<coefficients.size(); ++i)
+        coefficients(i) = solution(dof_indices(cell,i));
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
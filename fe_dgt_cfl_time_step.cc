@@ -0,0 +1,183 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cfl_time_step.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+CFLTimeStep<dim,spacedim>::
+CFLTimeStep (const DoFHandler<dim,spacedim> &dof_handler,
+             const WaveSpeedFunction        &wave_speed,
+             const WaveSpeedEstimate         estimate)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  wave_speed (wave_speed),
+  estimate (estimate)
+{
+  const FiniteElement<dim,spacedim> &system_fe = dof_handler.get_fe();
+  const FE_DGT<dim,spacedim> *fe
+    = dynamic_cast<const FE_DGT<dim,spacedim>*>(&system_fe.base_element(0));
+  AssertThrow (fe != 0,
+               ExcMessage ("The CFL time step requires FE_DGT elements."));
+  degree = fe->degree;
+  for (unsigned int b=1; b<system_fe.n_base_elements(); ++b)
+    AssertThrow (dynamic_cast<const FE_DGT<dim,spacedim>*>(&system_fe.base_element(b)) != 0
+                 &&
+                 system_fe.base_element(b).degree == degree,
+                 ExcMessage ("All base elements must be FE_DGT elements of the "
+                             "same degree."));
+
+  component_dofs.reinit (system_fe.n_components(), fe->dofs_per_cell);
+  for (unsigned int i=0; i<system_fe.dofs_per_cell; ++i)
+    component_dofs(system_fe.system_to_component_index(i).first,
+                   system_fe.system_to_component_index(i).second) = i;
+
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+CFLTimeStep<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+
+  diameters.resize (connectivity.n_cells());
+  for (unsigned int c=0; c<connectivity.n_cells(); ++c)
+    diameters[c] = connectivity.cells[c]->diameter();
+}
+
+
+
+template <int dim, int spacedim>
+double
+CFLTimeStep<dim,spacedim>::
+compute (const Vector<double> &solution,
+         const double          cfl) const
+{
+  return do_compute (solution, cfl, 0);
+}
+
+
+
+template <int dim, int spacedim>
+double
+CFLTimeStep<dim,spacedim>::
+compute (const Vector<double> &solution,
+         const double          cfl,
+         std::vector<double>  &cell_time_steps) const
+{
+  cell_time_steps.resize (connectivity.n_cells());
+  return do_compute (solution, cfl, &cell_time_steps);
+}
+
+
+
+template <int dim, int spacedim>
+double
+CFLTimeStep<dim,spacedim>::
+do_compute (const Vector<double> &solution,
+            const double          cfl,
+            std::vector<double>  *cell_time_steps) const
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  // each subrange reduces the time steps of its cells and combines the
+  // result with the others once, so there is no second pass over the cells
+  double time_step = std::numeric_limits<double>::max();
+  Threads::Mutex mutex;
+  parallel::apply_to_subranges (0U, connectivity.n_cells(),
+                                std_cxx11::bind (&CFLTimeStep<dim,spacedim>::compute_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (solution),
+                                                 cfl,
+                                                 cell_time_steps,
+                                                 std_cxx11::ref (time_step),
+                                                 std_cxx11::ref (mutex)),
+                                256);
+  return time_step;
+}
+
+
+
+template <int dim, int spacedim>
+void
+CFLTimeStep<dim,spacedim>::
+compute_cells (const unsigned int    begin,
+               const unsigned int    end,
+               const Vector<double> &solution,
+               const double          cfl,
+               std::vector<double>  *cell_time_steps,
+               double               &time_step,
+               Threads::Mutex       &mutex) const
+{
+  const unsigned int n_components = component_dofs.size(0);
+  const unsigned int dofs_per_cell = component_dofs.size(1);
+  Vector<double> values (n_components);
+  Vector<double> deviations (n_components);
+  double min_time_step = std::numeric_limits<double>::max();
+
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      for (unsigned int comp=0; comp<n_components; ++comp)
+        {
+          values(comp) = solution(connectivity.dof_indices(c,component_dofs(comp,0)));
+          if (estimate == coefficient_bound)
+            {
+              double deviation = 0;
+              for (unsigned int i=1; i<dofs_per_cell; ++i)
+                deviation += std::fabs (solution(connectivity.dof_indices(c,component_dofs(comp,i))));
+              deviations(comp) = deviation;
+            }
+        }
+
+      const double speed = wave_speed (values, deviations);
+      Assert (speed >= 0, ExcMessage ("The wave speed must not be negative."));
+      const double cell_time_step = (speed > 0 ?
+                                     cfl * diameters[c] / ((2*degree+1) * speed) :
+                                     std::numeric_limits<double>::max());
+      if (cell_time_steps != 0)
+        (*cell_time_steps)[c] = cell_time_step;
+      min_time_step = std::min (min_time_step, cell_time_step);
+    }
+
+  Threads::Mutex::ScopedLock lock (mutex);
+  time_step = std::min (time_step, min_time_step);
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_cfl_time_step.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,188 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_cfl_time_step_h
+#define dealii__fe_dgt_cfl_time_step_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * Compute the time step of explicit discontinuous Galerkin schemes with
+ * the FE_DGT element from the CFL condition
+ * @f[
+ *   \Delta t = \min_K \frac{\text{CFL}\; h_K}{(2k+1)\, s_K},
+ * @f]
+ * where $h_K$ is the diameter of cell $K$, $k$ the degree of the element
+ * and $s_K$ an estimate of the largest wave speed on $K$.
+ *
+ * The wave speed is computed by a user supplied function from the
+ * solution on each cell without evaluating any shape function. The first
+ * coefficient of FE_DGT is the value at the center of the cell, so the
+ * values at the centers are read directly from the solution vector. With
+ * the estimate #coefficient_bound, the function is additionally given the
+ * bound $\sum_{\alpha\neq 0}|c_\alpha|$ on the deviation of each component
+ * from its value at the center, which holds since the scaled coordinates
+ * $(x-x_c)/h$ do not exceed one in magnitude on the cell. A wave speed
+ * function can then bound the wave speed on the whole cell, e.g., by
+ * <tt>|values(0)|+deviations(0)</tt> for the Burgers equation.
+ *
+ * The cell diameters and the indices of the coefficients are collected
+ * once by reinit(), so that compute() is a single pass over the solution
+ * vector with a parallel loop over the cells.
+ *
+ * The DoFHandler may use an FE_DGT element or an FESystem whose base
+ * elements are all FE_DGT elements of the same degree. Components are
+ * passed to the wave speed function in the order of the finite element.
+ */
+template <int dim, int spacedim=dim>
+class CFLTimeStep : public Subscriptor
+{
+public:
+  /**
+   * The information passed to the wave speed function.
+   */
+  enum WaveSpeedEstimate
+  {
+    /**
+     * Only the values at the centers of the cells. The deviations passed
+     * to the wave speed function are zero.
+     */
+    center_values,
+    /**
+     * The values at the centers and bounds on the deviations from them on
+     * the cells.
+     */
+    coefficient_bound
+  };
+
+  /**
+   * A function that returns the largest wave speed on a cell, given the
+   * values of all components at the center of the cell and bounds on the
+   * deviations from them.
+   */
+  typedef std_cxx11::function<double (const Vector<double> &, const Vector<double> &)> WaveSpeedFunction;
+
+  /**
+   * Constructor. Calls reinit().
+   */
+  CFLTimeStep (const DoFHandler<dim,spacedim> &dof_handler,
+               const WaveSpeedFunction        &wave_speed,
+               const WaveSpeedEstimate         estimate = center_values);
+
+  /**
+   * Collect the diameters and the indices of degrees of freedom of all
+   * active cells. Must be called again whenever the mesh or the numbering
+   * of degrees of freedom changes.
+   */
+  void reinit ();
+
+  /**
+   * Return the time step for the given CFL number.
+   */
+  double compute (const Vector<double> &solution,
+                  const double          cfl) const;
+
+  /**
+   * Same as above, but also return the admissible time step of each active
+   * cell, indexed by active_cell_index(), e.g., for
+   * LocalTimeStepping::reinit(). Cells with vanishing wave speed obtain the
+   * largest representable number.
+   */
+  double compute (const Vector<double> &solution,
+                  const double          cfl,
+                  std::vector<double>  &cell_time_steps) const;
+
+private:
+  /**
+   * Common implementation of the two compute() functions. The time steps
+   * of the cells are only written if @p cell_time_steps is not the null
+   * pointer.
+   */
+  double do_compute (const Vector<double> &solution,
+                     const double          cfl,
+                     std::vector<double>  *cell_time_steps) const;
+
+  /**
+   * Compute the admissible time steps of the active cells with indices
+   * <tt>[begin,end)</tt>, write them into @p cell_time_steps unless it is
+   * the null pointer, and reduce @p time_step, which is guarded by
+   * @p mutex, to their minimum.
+   */
+  void compute_cells (const unsigned int    begin,
+                      const unsigned int    end,
+                      const Vector<double> &solution,
+                      const double          cfl,
+                      std::vector<double>  *cell_time_steps,
+                      double               &time_step,
+                      Threads::Mutex       &mutex) const;
+
+  /**
+   * The DoFHandler the solution vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,CFLTimeStep<dim,spacedim> > dof_handler;
+
+  /**
+   * The wave speed function.
+   */
+  const WaveSpeedFunction wave_speed;
+
+  /**
+   * The information passed to the wave speed function.
+   */
+  const WaveSpeedEstimate estimate;
+
+  /**
+   * The degree of the FE_DGT elements.
+   */
+  unsigned int degree;
+
+  /**
+   * The index within the cell of the degree of freedom of shape function
+   * @p i of component @p c, i.e., <tt>component_dofs(c,i)</tt>.
+   */
+  Table<2,unsigned int> component_dofs;
+
+  /**
+   * The active cells and their degrees of freedom.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The diameters of the active cells.
+   */
+  std::vector<double> diameters;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,791 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt_diffusion_operator.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // the coefficients of shape function j of cell unit_cell, i.e., a unit
+  // vector on that cell and zero on all others
+  void
+  unit_coefficients (const unsigned int  unit_cell,
+                     const unsigned int  j,
+                     const unsigned int  cell,
+                     Vector<double>     &coefficients)
+  {
+    coefficients = 0;
+    if (cell == unit_cell)
+      coefficients(j) = 1.;
+  }
+
+
+
+  // the gradient of a cell from a list of gradients computed beforehand
+  void
+  find_gradient (const std::map<unsigned int,std::vector<Vector<double> > > &gradients,
+                 const unsigned int                                          cell,
+                 std::vector<Vector<double> >                               &gradient)
+  {
+    const std::map<unsigned int,std::vector<Vector<double> > >::const_iterator
+    entry = gradients.find (cell);
+    Assert (entry != gradients.end(), ExcInternalError());
+    gradient = entry->second;
+  }
+
+
+
+  // y = A x for a dense block A of size n stored column by column
+  inline
+  void
+  block_vmult (const unsigned int  n,
+               const double       *A,
+               const double       *x,
+               double             *y)
+  {
+    for (unsigned int i=0; i<n; ++i)
+      y[i] = 0.;
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const double x_j = x[j];
+        const double *column = A + j*n;
+        DEAL_II_OPENMP_SIMD_PRAGMA
+        for (unsigned int i=0; i<n; ++i)
+          y[i] += column[i] * x_j;
+      }
+  }
+}
+
+
+
+template <int dim, int spacedim>
+DiffusionOperator<dim,spacedim>::ScratchData::
+ScratchData (const FE_DGT<dim,spacedim> &fe)
+  :
+  fe_values (fe, QGauss<dim>(fe.degree+1),
+             update_values | update_gradients | update_JxW_values),
+  fe_face_values (fe, QGauss<dim-1>(fe.degree+1),
+                  update_values | update_gradients | update_JxW_values |
+                  update_normal_vectors),
+  fe_subface_values (fe, QGauss<dim-1>(fe.degree+1),
+                     update_values | update_gradients | update_JxW_values |
+                     update_normal_vectors),
+  neighbor_face_values (fe, QGauss<dim-1>(fe.degree+1),
+                        update_values | update_gradients),
+  neighbor_subface_values (fe, QGauss<dim-1>(fe.degree+1),
+                           update_values | update_gradients),
+  cell_coefficients (fe.dofs_per_cell),
+  neighbor_coefficients (fe.dofs_per_cell),
+  cell_gradient (dim, Vector<double>(fe.dofs_per_cell)),
+  neighbor_gradient (dim, Vector<double>(fe.dofs_per_cell))
+{}
+
+
+
+template <int dim, int spacedim>
+DiffusionOperator<dim,spacedim>::
+DiffusionOperator (const DoFHandler<dim,spacedim> &dof_handler,
+                   const Method                    method,
+                   const double                    penalty_factor)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  method (method),
+  penalty_factor (penalty_factor)
+{
+  const FE_DGT<dim,spacedim> *dgt
+    = dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe());
+  AssertThrow (dgt != 0 && dgt->n_components() == 1,
+               ExcMessage ("The diffusion operator requires a scalar FE_DGT element."));
+  fe = dgt;
+
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+
+  diameters.resize (connectivity.n_cells());
+  for (unsigned int c=0; c<connectivity.n_cells(); ++c)
+    diameters[c] = connectivity.cells[c]->diameter();
+  diffusivity.assign (connectivity.n_cells(), 1.);
+
+  gradient.clear ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+set_diffusivity (const std::vector<double> &cell_diffusivity)
+{
+  AssertDimension (cell_diffusivity.size(), connectivity.n_cells());
+  diffusivity = cell_diffusivity;
+}
+
+
+
+template <int dim, int spacedim>
+types::global_dof_index
+DiffusionOperator<dim,spacedim>::m () const
+{
+  return dof_handler->n_dofs();
+}
+
+
+
+template <int dim, int spacedim>
+types::global_dof_index
+DiffusionOperator<dim,spacedim>::n () const
+{
+  return dof_handler->n_dofs();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DiffusionOperator<dim,spacedim>::block_size () const
+{
+  return fe->dofs_per_cell;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DiffusionOperator<dim,spacedim>::n_cells () const
+{
+  return connectivity.n_cells();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DiffusionOperator<dim,spacedim>::
+n_face_parts (const unsigned int cell,
+              const unsigned int face_no) const
+{
+  const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell_it = connectivity.cells[cell];
+  if (!cell_it->at_boundary(face_no) && cell_it->neighbor(face_no)->has_children())
+    return cell_it->face(face_no)->n_children();
+  return 1;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DiffusionOperator<dim,spacedim>::
+reinit_face (const unsigned int                   cell,
+             const unsigned int                   face_no,
+             const unsigned int                   part,
+             ScratchData                         &scratch,
+             const FEFaceValuesBase<dim,spacedim> *&cell_values,
+             const FEFaceValuesBase<dim,spacedim> *&neighbor_values) const
+{
+  const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell_it = connectivity.cells[cell];
+  neighbor_values = 0;
+
+  if (cell_it->at_boundary(face_no))
+    {
+      scratch.fe_face_values.reinit (cell_it, face_no);
+      cell_values = &scratch.fe_face_values;
+      return numbers::invalid_unsigned_int;
+    }
+
+  const typename DoFHandler<dim,spacedim>::cell_iterator neighbor = cell_it->neighbor(face_no);
+  if (neighbor->has_children())
+    {
+      // the neighbor is refined: integrate over the part of the face shared
+      // with one of its children
+      const typename DoFHandler<dim,spacedim>::cell_iterator
+      child = cell_it->neighbor_child_on_subface (face_no, part);
+      scratch.fe_subface_values.reinit (cell_it, face_no, part);
+      scratch.neighbor_face_values.reinit (child, cell_it->neighbor_of_neighbor(face_no));
+      cell_values = &scratch.fe_subface_values;
+      neighbor_values = &scratch.neighbor_face_values;
+      return child->active_cell_index();
+    }
+
+  scratch.fe_face_values.reinit (cell_it, face_no);
+  cell_values = &scratch.fe_face_values;
+  if (cell_it->neighbor_is_coarser(face_no))
+    {
+      // the face is part of a face of the neighbor
+      const std::pair<unsigned int,unsigned int>
+      neighbor_face = cell_it->neighbor_of_coarser_neighbor (face_no);
+      scratch.neighbor_subface_values.reinit (neighbor, neighbor_face.first, neighbor_face.second);
+      neighbor_values = &scratch.neighbor_subface_values;
+    }
+  else
+    {
+      scratch.neighbor_face_values.reinit (neighbor, cell_it->neighbor_of_neighbor(face_no));
+      neighbor_values = &scratch.neighbor_face_values;
+    }
+  return neighbor->active_cell_index();
+}
+
+
+
+template <int dim, int spacedim>
+double
+DiffusionOperator<dim,spacedim>::
+penalty (const unsigned int cell,
+         const unsigned int neighbor) const
+{
+  double nu = diffusivity[cell];
+  double h = diameters[cell];
+  if (neighbor != numbers::invalid_unsigned_int)
+    {
+      nu = std::max (nu, diffusivity[neighbor]);
+      h = std::min (h, diameters[neighbor]);
+    }
+  return penalty_factor * (fe->degree+1) * (fe->degree+1) * nu / h;
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+sipg_residual (const unsigned int         cell,
+               const CoefficientFunction &coefficients,
+               ScratchData               &scratch,
+               Vector<double>            &residual) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const double nu = diffusivity[cell];
+  Vector<double> &u = scratch.cell_coefficients;
+  Vector<double> &u_neighbor = scratch.neighbor_coefficients;
+  coefficients (cell, u);
+  residual = 0;
+
+  // the cell integral
+  const FEValues<dim,spacedim> &fe_values = scratch.fe_values;
+  scratch.fe_values.reinit (connectivity.cells[cell]);
+  for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+    {
+      Tensor<1,spacedim> flux;
+      for (unsigned int j=0; j<dofs_per_cell; ++j)
+        flux += u(j) * fe_values.shape_grad(j,q);
+      flux *= nu * fe_values.JxW(q);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        residual(i) += flux * fe_values.shape_grad(i,q);
+    }
+
+  // the face integrals, with the jump u-u_neighbor in the direction of the
+  // outer normal of the cell
+  for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+    for (unsigned int part=0; part<n_face_parts(cell,f); ++part)
+      {
+        const FEFaceValuesBase<dim,spacedim> *cell_values, *neighbor_values;
+        const unsigned int neighbor = reinit_face (cell, f, part, scratch,
+                                                   cell_values, neighbor_values);
+        const double sigma = penalty (cell, neighbor);
+        const double nu_neighbor = (neighbor != numbers::invalid_unsigned_int ?
+                                    diffusivity[neighbor] : 0.);
+        if (neighbor != numbers::invalid_unsigned_int)
+          coefficients (neighbor, u_neighbor);
+
+        for (unsigned int q=0; q<cell_values->n_quadrature_points; ++q)
+          {
+            const Tensor<1,spacedim> &normal = cell_values->normal_vector(q);
+            double value = 0, normal_flux = 0;
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              {
+                value += u(j) * cell_values->shape_value(j,q);
+                normal_flux += u(j) * (cell_values->shape_grad(j,q) * normal);
+              }
+            normal_flux *= nu;
+
+            // at the boundary, the neighbor values are zero and the
+            // averages are the values of the cell
+            double jump = value, average_flux = normal_flux, weight = 1.;
+            if (neighbor != numbers::invalid_unsigned_int)
+              {
+                double neighbor_value = 0, neighbor_flux = 0;
+                for (unsigned int j=0; j<dofs_per_cell; ++j)
+                  {
+                    neighbor_value += u_neighbor(j) * neighbor_values->shape_value(j,q);
+                    neighbor_flux += u_neighbor(j) * (neighbor_values->shape_grad(j,q) * normal);
+                  }
+                jump -= neighbor_value;
+                average_flux = 0.5 * (normal_flux + nu_neighbor * neighbor_flux);
+                weight = 0.5;
+              }
+
+            const double JxW = cell_values->JxW(q);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              residual(i) += ((sigma * jump - average_flux) * cell_values->shape_value(i,q)
+                              - weight * nu * jump * (cell_values->shape_grad(i,q) * normal)) * JxW;
+          }
+      }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+ldg_gradient (const unsigned int             cell,
+              const CoefficientFunction     &coefficients,
+              ScratchData                   &scratch,
+              std::vector<Vector<double> >  &gradient) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  Vector<double> &u = scratch.cell_coefficients;
+  Vector<double> &u_neighbor = scratch.neighbor_coefficients;
+  coefficients (cell, u);
+  gradient.resize (dim);
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      gradient[d].reinit (dofs_per_cell);
+      scratch.cell_gradient[d] = 0;
+    }
+
+  // the right hand sides int grad(u) phi_j + int (u_hat-u) n phi_j,
+  // collected in cell_gradient
+  const FEValues<dim,spacedim> &fe_values = scratch.fe_values;
+  scratch.fe_values.reinit (connectivity.cells[cell]);
+  for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+    {
+      Tensor<1,spacedim> grad_u;
+      for (unsigned int j=0; j<dofs_per_cell; ++j)
+        grad_u += u(j) * fe_values.shape_grad(j,q);
+      grad_u *= fe_values.JxW(q);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int d=0; d<dim; ++d)
+          scratch.cell_gradient[d](i) += grad_u[d] * fe_values.shape_value(i,q);
+    }
+
+  for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+    for (unsigned int part=0; part<n_face_parts(cell,f); ++part)
+      {
+        const FEFaceValuesBase<dim,spacedim> *cell_values, *neighbor_values;
+        const unsigned int neighbor = reinit_face (cell, f, part, scratch,
+                                                   cell_values, neighbor_values);
+        if (neighbor != numbers::invalid_unsigned_int)
+          coefficients (neighbor, u_neighbor);
+
+        for (unsigned int q=0; q<cell_values->n_quadrature_points; ++q)
+          {
+            const Tensor<1,spacedim> &normal = cell_values->normal_vector(q);
+            double value = 0;
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              value += u(j) * cell_values->shape_value(j,q);
+
+            // u_hat-u is (1/2-beta)(u_neighbor-u) inside and -u at the
+            // boundary
+            double difference = -value;
+            if (neighbor != numbers::invalid_unsigned_int)
+              {
+                double neighbor_value = 0;
+                for (unsigned int j=0; j<dofs_per_cell; ++j)
+                  neighbor_value += u_neighbor(j) * neighbor_values->shape_value(j,q);
+                double switch_normal = 0;
+                for (unsigned int d=0; d<spacedim; ++d)
+                  switch_normal += normal[d];
+                const double beta = (switch_normal > 0 ? 0.5 : (switch_normal < 0 ? -0.5 : 0.));
+                difference = (0.5 - beta) * (neighbor_value - value);
+              }
+
+            const double JxW = cell_values->JxW(q);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              for (unsigned int d=0; d<dim; ++d)
+                scratch.cell_gradient[d](i) += difference * normal[d] *
+                                               cell_values->shape_value(i,q) * JxW;
+          }
+      }
+
+  for (unsigned int d=0; d<dim; ++d)
+    fe->apply_inverse_mass_matrix (shape_classes, connectivity.cells[cell],
+                                   scratch.cell_gradient[d], gradient[d]);
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+ldg_residual (const unsigned int         cell,
+              const CoefficientFunction &coefficients,
+              const GradientFunction    &gradients,
+              ScratchData               &scratch,
+              Vector<double>            &residual) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const double nu = diffusivity[cell];
+  Vector<double> &u = scratch.cell_coefficients;
+  Vector<double> &u_neighbor = scratch.neighbor_coefficients;
+  std::vector<Vector<double> > &q_cell = scratch.cell_gradient;
+  std::vector<Vector<double> > &q_neighbor = scratch.neighbor_gradient;
+  coefficients (cell, u);
+  gradients (cell, q_cell);
+  residual = 0;
+
+  // the cell integral of nu q . grad(phi_i)
+  const FEValues<dim,spacedim> &fe_values = scratch.fe_values;
+  scratch.fe_values.reinit (connectivity.cells[cell]);
+  for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+    {
+      Tensor<1,spacedim> flux;
+      for (unsigned int j=0; j<dofs_per_cell; ++j)
+        for (unsigned int d=0; d<dim; ++d)
+          flux[d] += q_cell[d](j) * fe_values.shape_value(j,q);
+      flux *= nu * fe_values.JxW(q);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        residual(i) += flux * fe_values.shape_grad(i,q);
+    }
+
+  // the face integrals of -(flux_hat . n - sigma (u-u_neighbor)) phi_i
+  for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+    for (unsigned int part=0; part<n_face_parts(cell,f); ++part)
+      {
+        const FEFaceValuesBase<dim,spacedim> *cell_values, *neighbor_values;
+        const unsigned int neighbor = reinit_face (cell, f, part, scratch,
+                                                   cell_values, neighbor_values);
+        const double sigma = penalty (cell, neighbor);
+        if (neighbor != numbers::invalid_unsigned_int)
+          {
+            coefficients (neighbor, u_neighbor);
+            gradients (neighbor, q_neighbor);
+          }
+
+        for (unsigned int q=0; q<cell_values->n_quadrature_points; ++q)
+          {
+            const Tensor<1,spacedim> &normal = cell_values->normal_vector(q);
+            double value = 0, normal_flux = 0;
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              {
+                const double phi = cell_values->shape_value(j,q);
+                value += u(j) * phi;
+                for (unsigned int d=0; d<dim; ++d)
+                  normal_flux += q_cell[d](j) * phi * normal[d];
+              }
+            normal_flux *= nu;
+
+            double jump = value, flux_hat = normal_flux;
+            if (neighbor != numbers::invalid_unsigned_int)
+              {
+                double neighbor_value = 0, neighbor_flux = 0;
+                for (unsigned int j=0; j<dofs_per_cell; ++j)
+                  {
+                    const double phi = neighbor_values->shape_value(j,q);
+                    neighbor_value += u_neighbor(j) * phi;
+                    for (unsigned int d=0; d<dim; ++d)
+                      neighbor_flux += q_neighbor[d](j) * phi * normal[d];
+                  }
+                neighbor_flux *= diffusivity[neighbor];
+                double switch_normal = 0;
+                for (unsigned int d=0; d<spacedim; ++d)
+                  switch_normal += normal[d];
+                const double beta = (switch_normal > 0 ? 0.5 : (switch_normal < 0 ? -0.5 : 0.));
+                jump -= neighbor_value;
+                flux_hat = (0.5 - beta) * normal_flux + (0.5 + beta) * neighbor_flux;
+              }
+
+            const double JxW = cell_values->JxW(q);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              residual(i) += (sigma * jump - flux_hat) * cell_values->shape_value(i,q) * JxW;
+          }
+      }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  if (method == local_discontinuous_galerkin)
+    {
+      gradient.resize (dim);
+      for (unsigned int d=0; d<dim; ++d)
+        gradient[d].reinit (src.size(), true);
+      parallel::apply_to_subranges (0U, connectivity.n_cells(),
+                                    std_cxx11::bind (&DiffusionOperator<dim,spacedim>::ldg_gradient_cells,
+                                                     this,
+                                                     std_cxx11::_1, std_cxx11::_2,
+                                                     std_cxx11::cref (src)),
+                                    64);
+    }
+
+  parallel::apply_to_subranges (0U, connectivity.n_cells(),
+                                std_cxx11::bind (&DiffusionOperator<dim,spacedim>::vmult_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+ldg_gradient_cells (const unsigned int    begin,
+                    const unsigned int    end,
+                    const Vector<double> &src) const
+{
+  ScratchData scratch (*fe);
+  const CoefficientFunction
+  coefficients = std_cxx11::bind (&internal::FE_DGTImplementation::CellConnectivity<dim,spacedim>::get_coefficients,
+                                  std_cxx11::cref (connectivity),
+                                  std_cxx11::cref (src),
+                                  std_cxx11::_1, std_cxx11::_2);
+  std::vector<Vector<double> > cell_gradient;
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      ldg_gradient (c, coefficients, scratch, cell_gradient);
+      for (unsigned int d=0; d<dim; ++d)
+        for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+          gradient[d](connectivity.dof_indices(c,i)) = cell_gradient[d](i);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+get_stored_gradient (const unsigned int            cell,
+                     std::vector<Vector<double> > &cell_gradient) const
+{
+  cell_gradient.resize (dim);
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      cell_gradient[d].reinit (fe->dofs_per_cell, true);
+      connectivity.get_coefficients (gradient[d], cell, cell_gradient[d]);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+vmult_cells (const unsigned int    begin,
+             const unsigned int    end,
+             Vector<double>       &dst,
+             const Vector<double> &src) const
+{
+  ScratchData scratch (*fe);
+  const CoefficientFunction
+  coefficients = std_cxx11::bind (&internal::FE_DGTImplementation::CellConnectivity<dim,spacedim>::get_coefficients,
+                                  std_cxx11::cref (connectivity),
+                                  std_cxx11::cref (src),
+                                  std_cxx11::_1, std_cxx11::_2);
+  const GradientFunction
+  gradients = std_cxx11::bind (&DiffusionOperator<dim,spacedim>::get_stored_gradient,
+                               this,
+                               std_cxx11::_1, std_cxx11::_2);
+
+  Vector<double> residual (fe->dofs_per_cell);
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      if (method == symmetric_interior_penalty)
+        sipg_residual (c, coefficients, scratch, residual);
+      else
+        ldg_residual (c, coefficients, gradients, scratch, residual);
+      for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+        dst(connectivity.dof_indices(c,i)) = residual(i);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+compute_diagonal_block (const unsigned int  cell,
+                        FullMatrix<double> &block) const
+{
+  ScratchData scratch (*fe);
+  compute_diagonal_block (cell, scratch, block);
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionOperator<dim,spacedim>::
+compute_diagonal_block (const unsigned int  cell,
+                        ScratchData        &scratch,
+                        FullMatrix<double> &block) const
+{
+  AssertIndexRange (cell, connectivity.n_cells());
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  block.reinit (dofs_per_cell, dofs_per_cell);
+
+  Vector<double> residual (dofs_per_cell);
+  std::map<unsigned int,std::vector<Vector<double> > > local_gradients;
+  for (unsigned int j=0; j<dofs_per_cell; ++j)
+    {
+      const CoefficientFunction
+      coefficients = std_cxx11::bind (&unit_coefficients, cell, j,
+                                      std_cxx11::_1, std_cxx11::_2);
+      if (method == symmetric_interior_penalty)
+        sipg_residual (cell, coefficients, scratch, residual);
+      else
+        {
+          // the LDG gradient of a shape function of the cell is nonzero on
+          // the cell and its face neighbors
+          local_gradients.clear ();
+          ldg_gradient (cell, coefficients, scratch, local_gradients[cell]);
+          for (unsigned int n=connectivity.neighbor_start[cell];
+               n<connectivity.neighbor_start[cell+1]; ++n)
+            ldg_gradient (connectivity.neighbors[n], coefficients, scratch,
+                          local_gradients[connectivity.neighbors[n]]);
+          ldg_residual (cell, coefficients,
+                        std_cxx11::bind (&find_gradient, std_cxx11::cref (local_gradients),
+                                         std_cxx11::_1, std_cxx11::_2),
+                        scratch, residual);
+        }
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        block(i,j) = residual(i);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+DiffusionOperator<dim,spacedim>::memory_consumption () const
+{
+  return (MemoryConsumption::memory_consumption (connectivity.dof_indices) +
+          MemoryConsumption::memory_consumption (connectivity.neighbor_start) +
+          MemoryConsumption::memory_consumption (connectivity.neighbors) +
+          MemoryConsumption::memory_consumption (diameters) +
+          MemoryConsumption::memory_consumption (diffusivity) +
+          MemoryConsumption::memory_consumption (gradient));
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionBlockJacobi<dim,spacedim>::initialize (const DiffusionOperator<dim,spacedim> &op)
+{
+  size = op.block_size();
+  dof_indices.reinit (op.n_cells(), size);
+  inverse_diagonal.resize (op.n_cells() * size * size);
+  parallel::apply_to_subranges (0U, op.n_cells(),
+                                std_cxx11::bind (&DiffusionBlockJacobi<dim,spacedim>::initialize_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (op)),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionBlockJacobi<dim,spacedim>::
+initialize_cells (const unsigned int                     begin,
+                  const unsigned int                     end,
+                  const DiffusionOperator<dim,spacedim> &op)
+{
+  typename DiffusionOperator<dim,spacedim>::ScratchData scratch (*op.fe);
+  FullMatrix<double> block;
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      for (unsigned int i=0; i<size; ++i)
+        dof_indices(c,i) = op.connectivity.dof_indices(c,i);
+
+      op.compute_diagonal_block (c, scratch, block);
+      block.gauss_jordan ();
+      for (unsigned int j=0; j<size; ++j)
+        for (unsigned int i=0; i<size; ++i)
+          inverse_diagonal[(c*size+j)*size+i] = block(i,j);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionBlockJacobi<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), src.size());
+  parallel::apply_to_subranges (0U, dof_indices.size(0),
+                                std_cxx11::bind (&DiffusionBlockJacobi<dim,spacedim>::vmult_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+DiffusionBlockJacobi<dim,spacedim>::
+vmult_cells (const unsigned int    begin,
+             const unsigned int    end,
+             Vector<double>       &dst,
+             const Vector<double> &src) const
+{
+  std::vector<double> x (size);
+  std::vector<double> y (size);
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      for (unsigned int j=0; j<size; ++j)
+        x[j] = src(dof_indices(c,j));
+      block_vmult (size, inverse_diagonal.begin() + c*size*size, &x[0], &y[0]);
+      for (unsigned int i=0; i<size; ++i)
+        dst(dof_indices(c,i)) = y[i];
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_diffusion_operator.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,392 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_diffusion_operator_h
+#define dealii__fe_dgt_diffusion_operator_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <map>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * Matrix-free application of the discontinuous Galerkin discretization
+ * of the diffusion operator $-\nabla\cdot(\nu\nabla u)$ with the FE_DGT
+ * element, e.g., as the Jacobian of the viscous terms in an implicit
+ * solver. Since the operator is linear in $u$ for a given diffusivity,
+ * vmult() is the product of the Jacobian with a vector, computed from the
+ * shape functions of FEValues, FEFaceValues and FESubfaceValues without
+ * assembling a matrix. The class can therefore be passed as the matrix to
+ * the Krylov solvers of the library, with DiffusionBlockJacobi as
+ * preconditioner.
+ *
+ * Two discretizations are implemented, both with homogeneous Dirichlet
+ * conditions on the whole boundary, which is the Jacobian of any
+ * Dirichlet problem:
+ * <ul>
+ * <li> The symmetric interior penalty method (SIPG)
+ * @f[
+ *   a(u,v) = \sum_K \int_K \nu\nabla u\cdot\nabla v
+ *   - \sum_F \int_F \left(\{\nu\nabla u\}\cdot n\,[v]
+ *                         + \{\nu\nabla v\}\cdot n\,[u]\right)
+ *   + \sum_F \int_F \sigma [u][v].
+ * @f]
+ * <li> The local discontinuous Galerkin method (LDG), which first computes
+ * the gradient $q$ in the DG space from
+ * $\int_K q\cdot\tau = \int_K \nabla u\cdot\tau + \int_{\partial K}
+ * (\hat u - u)\,\tau\cdot n$ and then tests $-\nabla\cdot(\nu q)$ with the
+ * flux $\widehat{\nu q}\cdot n - \sigma [u]$. The fluxes are the
+ * alternating ones, $\hat u = \{u\} + \beta [u]$ and $\widehat{\nu q} =
+ * \{\nu q\} - \beta [\nu q]$ with $\beta = \frac 12
+ * \mathrm{sign}(s\cdot n)$ for the fixed switch direction
+ * $s=(1,\ldots,1)$, and the gradient is computed with the exact inverse
+ * mass matrix of FE_DGT.
+ * </ul>
+ * The penalty on a face is $\sigma = \eta (k+1)^2 \nu / h$, with the
+ * penalty factor $\eta$, the degree $k$ of the element, and the larger
+ * diffusivity and smaller diameter of the two adjacent cells.
+ *
+ * The diffusivity is constant on each cell and set by set_diffusivity(),
+ * e.g., frozen at the current Newton iterate of a nonlinear problem. Each
+ * cell computes its own rows from both sides of its faces, so that the
+ * products run in parallel over the cells without synchronization, at the
+ * price of evaluating the integrals on interior faces twice. Hanging
+ * nodes are supported for isotropically refined meshes, and the faces
+ * must be in standard orientation, so that the quadrature points of both
+ * sides of a face coincide.
+ *
+ * The DoFHandler must use a scalar FE_DGT element.
+ */
+template <int dim, int spacedim=dim>
+class DiffusionOperator : public Subscriptor
+{
+public:
+  /**
+   * The discretization of the diffusion operator.
+   */
+  enum Method
+  {
+    /**
+     * The symmetric interior penalty method.
+     */
+    symmetric_interior_penalty,
+    /**
+     * The local discontinuous Galerkin method with alternating fluxes.
+     */
+    local_discontinuous_galerkin
+  };
+
+  /**
+   * Constructor. Calls reinit(). The default penalty factor makes SIPG
+   * coercive on shape regular meshes.
+   */
+  DiffusionOperator (const DoFHandler<dim,spacedim> &dof_handler,
+                     const Method                    method,
+                     const double                    penalty_factor = 2.);
+
+  /**
+   * Collect the cells and their degrees of freedom and set the diffusivity
+   * to one on all cells. Must be called again whenever the mesh or the
+   * numbering of degrees of freedom changes.
+   */
+  void reinit ();
+
+  /**
+   * Set the diffusivity of the active cells, indexed by
+   * active_cell_index().
+   */
+  void set_diffusivity (const std::vector<double> &cell_diffusivity);
+
+  /**
+   * Return the number of rows, i.e., the number of degrees of freedom.
+   */
+  types::global_dof_index m () const;
+
+  /**
+   * Return the number of columns, i.e., the number of degrees of freedom.
+   */
+  types::global_dof_index n () const;
+
+  /**
+   * Apply the operator, <tt>dst = A*src</tt>, in parallel over the cells.
+   * For LDG, the gradient of @p src is computed in a first parallel pass
+   * and stored in this object, so different threads must not call this
+   * function on the same object concurrently.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+  /**
+   * Compute the block of the operator that couples the degrees of freedom
+   * of the cell with active_cell_index() @p cell with themselves, column by
+   * column from the operator applied to the shape functions of the cell.
+   *
+   * This function sets up its own FEValues objects. DiffusionBlockJacobi
+   * uses a variant that shares them among all cells of a thread.
+   */
+  void compute_diagonal_block (const unsigned int  cell,
+                               FullMatrix<double> &block) const;
+
+  /**
+   * Return the number of degrees of freedom per cell.
+   */
+  unsigned int block_size () const;
+
+  /**
+   * Return the number of active cells.
+   */
+  unsigned int n_cells () const;
+
+  /**
+   * Memory consumption in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * A function that writes the coefficients of the cell with the given
+   * active_cell_index() into the vector, or the coefficients of the
+   * gradient for each direction into the vectors.
+   */
+  typedef std_cxx11::function<void (const unsigned int, Vector<double> &)> CoefficientFunction;
+  typedef std_cxx11::function<void (const unsigned int, std::vector<Vector<double> > &)> GradientFunction;
+
+  /**
+   * The FEValues objects and temporary vectors of a thread.
+   */
+  struct ScratchData
+  {
+    ScratchData (const FE_DGT<dim,spacedim> &fe);
+
+    FEValues<dim,spacedim>        fe_values;
+    FEFaceValues<dim,spacedim>    fe_face_values;
+    FESubfaceValues<dim,spacedim> fe_subface_values;
+    FEFaceValues<dim,spacedim>    neighbor_face_values;
+    FESubfaceValues<dim,spacedim> neighbor_subface_values;
+
+    Vector<double> cell_coefficients;
+    Vector<double> neighbor_coefficients;
+    std::vector<Vector<double> > cell_gradient;
+    std::vector<Vector<double> > neighbor_gradient;
+  };
+
+  /**
+   * Same as the public function of the same name, but use the FEValues
+   * objects and vectors in @p scratch.
+   */
+  void compute_diagonal_block (const unsigned int  cell,
+                               ScratchData        &scratch,
+                               FullMatrix<double> &block) const;
+
+  /**
+   * Return the number of parts of face @p face_no of @p cell, i.e., the
+   * number of neighbors across the face.
+   */
+  unsigned int n_face_parts (const unsigned int cell,
+                             const unsigned int face_no) const;
+
+  /**
+   * Initialize the face values of @p scratch on part @p part of face
+   * @p face_no of @p cell, and return them for the cell and the neighbor.
+   * Returns the active_cell_index() of the neighbor, or
+   * numbers::invalid_unsigned_int at the boundary, where the neighbor
+   * values are not initialized.
+   */
+  unsigned int reinit_face (const unsigned int                   cell,
+                            const unsigned int                   face_no,
+                            const unsigned int                   part,
+                            ScratchData                         &scratch,
+                            const FEFaceValuesBase<dim,spacedim> *&cell_values,
+                            const FEFaceValuesBase<dim,spacedim> *&neighbor_values) const;
+
+  /**
+   * Return the penalty on the face between @p cell and @p neighbor. At the
+   * boundary, @p neighbor is numbers::invalid_unsigned_int.
+   */
+  double penalty (const unsigned int cell,
+                  const unsigned int neighbor) const;
+
+  /**
+   * Compute the rows of @p cell of the SIPG operator applied to the
+   * coefficients given by @p coefficients.
+   */
+  void sipg_residual (const unsigned int         cell,
+                      const CoefficientFunction &coefficients,
+                      ScratchData               &scratch,
+                      Vector<double>            &residual) const;
+
+  /**
+   * Compute the coefficients of the LDG gradient on @p cell.
+   */
+  void ldg_gradient (const unsigned int             cell,
+                     const CoefficientFunction     &coefficients,
+                     ScratchData                   &scratch,
+                     std::vector<Vector<double> >  &gradient) const;
+
+  /**
+   * Compute the rows of @p cell of the LDG operator, given the
+   * coefficients and the gradients of the cells.
+   */
+  void ldg_residual (const unsigned int         cell,
+                     const CoefficientFunction &coefficients,
+                     const GradientFunction    &gradients,
+                     ScratchData               &scratch,
+                     Vector<double>            &residual) const;
+
+  /**
+   * Compute the LDG gradients of the cells <tt>[begin,end)</tt> for
+   * vmult() and store them in #gradient.
+   */
+  void ldg_gradient_cells (const unsigned int    begin,
+                           const unsigned int    end,
+                           const Vector<double> &src) const;
+
+  /**
+   * Compute the rows of the cells <tt>[begin,end)</tt> of vmult().
+   */
+  void vmult_cells (const unsigned int    begin,
+                    const unsigned int    end,
+                    Vector<double>       &dst,
+                    const Vector<double> &src) const;
+
+  /**
+   * Copy the coefficients of the stored gradient of @p cell.
+   */
+  void get_stored_gradient (const unsigned int            cell,
+                            std::vector<Vector<double> > &gradient) const;
+
+  /**
+   * The DoFHandler the vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,DiffusionOperator<dim,spacedim> > dof_handler;
+
+  /**
+   * The finite element.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,DiffusionOperator<dim,spacedim> > fe;
+
+  /**
+   * The discretization.
+   */
+  const Method method;
+
+  /**
+   * The penalty factor $\eta$.
+   */
+  const double penalty_factor;
+
+  /**
+   * The active cells, their degrees of freedom and face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+
+  /**
+   * The diameters and the diffusivities of the active cells.
+   */
+  std::vector<double> diameters;
+  std::vector<double> diffusivity;
+
+  /**
+   * The coefficients of the LDG gradient of the vector of the last
+   * vmult(), for each direction.
+   */
+  mutable std::vector<Vector<double> > gradient;
+
+  template <int, int> friend class DiffusionBlockJacobi;
+};
+
+
+
+/**
+ * Block Jacobi preconditioner for DiffusionOperator, i.e., multiplication
+ * by the inverses of the blocks of the operator on the cells. The blocks
+ * are computed and inverted once by initialize(), e.g., once per Newton
+ * step, and cached, so that the preconditioner, like the operator, needs
+ * no global matrix.
+ */
+template <int dim, int spacedim=dim>
+class DiffusionBlockJacobi : public Subscriptor
+{
+public:
+  /**
+   * Compute and invert the diagonal blocks of @p op, in parallel over the
+   * cells.
+   */
+  void initialize (const DiffusionOperator<dim,spacedim> &op);
+
+  /**
+   * Apply the preconditioner, in parallel over the cells.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+private:
+  /**
+   * Compute and invert the blocks of the cells <tt>[begin,end)</tt>.
+   */
+  void initialize_cells (const unsigned int                     begin,
+                         const unsigned int                     end,
+                         const DiffusionOperator<dim,spacedim> &op);
+
+  /**
+   * Apply the inverses on the cells <tt>[begin,end)</tt>.
+   */
+  void vmult_cells (const unsigned int    begin,
+                    const unsigned int    end,
+                    Vector<double>       &dst,
+                    const Vector<double> &src) const;
+
+  /**
+   * The size of the blocks.
+   */
+  unsigned int size;
+
+  /**
+   * The global indices of the degrees of freedom of each cell.
+   */
+  Table<2,types::global_dof_index> dof_indices;
+
+  /**
+   * The inverses of the diagonal blocks, stored column by column.
+   */
+  AlignedVector<double> inverse_diagonal;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,331 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt_local_time_stepping.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+LocalTimeStepping<dim,spacedim>::
+LocalTimeStepping (const DoFHandler<dim,spacedim> &dof_handler,
+                   const unsigned int              max_n_clusters)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  max_n_clusters (max_n_clusters)
+{
+  Assert (max_n_clusters > 0, ExcMessage ("There must be at least one cluster."));
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::reinit ()
+{
+  std::vector<double> diameters (dof_handler->get_triangulation().n_active_cells());
+  for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+       cell = dof_handler->begin_active(); cell != dof_handler->end(); ++cell)
+    diameters[cell->active_cell_index()] = cell->diameter();
+  reinit (diameters);
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+reinit (const std::vector<double> &time_steps)
+{
+  // the mesh may have changed without changing the number of cells, so
+  // always rebuild the neighbor lists
+  connectivity.reinit (*dof_handler);
+  const unsigned int n_cells = connectivity.n_cells();
+  AssertDimension (time_steps.size(), n_cells);
+  admissible_time_steps = time_steps;
+
+  // put each cell into the coarsest cluster whose time step
+  // max_step/2^l does not exceed its admissible time step
+  const double max_step = (n_cells > 0 ?
+                           *std::max_element (time_steps.begin(), time_steps.end()) :
+                           1.);
+  cell_clusters.resize (n_cells);
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      Assert (time_steps[c] > 0, ExcMessage ("The time steps must be positive."));
+      const double level = std::ceil (std::log (max_step/time_steps[c]) / std::log (2.) - 1e-12);
+      cell_clusters[c] = static_cast<unsigned int>(std::min (std::max (level, 0.),
+                                                             max_n_clusters-1.));
+    }
+
+  // neighbors may differ by at most one cluster. moving cells to finer
+  // clusters keeps their time steps admissible
+  bool changed = true;
+  while (changed)
+    {
+      changed = false;
+      for (unsigned int c=0; c<n_cells; ++c)
+        for (unsigned int n=connectivity.neighbor_start[c]; n<connectivity.neighbor_start[c+1]; ++n)
+          if (cell_clusters[connectivity.neighbors[n]] > cell_clusters[c] + 1)
+            {
+              cell_clusters[c] = cell_clusters[connectivity.neighbors[n]] - 1;
+              changed = true;
+            }
+    }
+
+  unsigned int n_clusters = 0;
+  for (unsigned int c=0; c<n_cells; ++c)
+    n_clusters = std::max (n_clusters, cell_clusters[c]+1);
+  clusters.clear ();
+  clusters.resize (n_clusters);
+  for (unsigned int c=0; c<n_cells; ++c)
+    clusters[cell_clusters[c]].push_back (c);
+
+  // buffers for the faces to coarser neighbors, and the reverse lookup
+  // from the coarse cells
+  const unsigned int dofs_per_cell = dof_handler->get_fe().dofs_per_cell;
+  interface_buffers.clear ();
+  interface_buffers.resize (connectivity.neighbors.size());
+  std::vector<std::vector<unsigned int> > finer_entries (n_cells);
+  for (unsigned int c=0; c<n_cells; ++c)
+    for (unsigned int n=connectivity.neighbor_start[c]; n<connectivity.neighbor_start[c+1]; ++n)
+      if (cell_clusters[connectivity.neighbors[n]] < cell_clusters[c])
+        {
+          interface_buffers[n].reinit (dofs_per_cell);
+          finer_entries[connectivity.neighbors[n]].push_back (n);
+        }
+
+  finer_neighbor_start.resize (n_cells+1);
+  finer_neighbor_entries.clear ();
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      finer_neighbor_start[c] = finer_neighbor_entries.size();
+      finer_neighbor_entries.insert (finer_neighbor_entries.end(),
+                                     finer_entries[c].begin(), finer_entries[c].end());
+    }
+  finer_neighbor_start[n_cells] = finer_neighbor_entries.size();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+LocalTimeStepping<dim,spacedim>::n_clusters () const
+{
+  return clusters.size();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+LocalTimeStepping<dim,spacedim>::cluster_of_cell (const unsigned int cell) const
+{
+  AssertIndexRange (cell, cell_clusters.size());
+  return cell_clusters[cell];
+}
+
+
+
+template <int dim, int spacedim>
+const std::vector<unsigned int> &
+LocalTimeStepping<dim,spacedim>::cells_in_cluster (const unsigned int cluster) const
+{
+  AssertIndexRange (cluster, clusters.size());
+  return clusters[cluster];
+}
+
+
+
+template <int dim, int spacedim>
+double
+LocalTimeStepping<dim,spacedim>::max_time_step (const double scaling) const
+{
+  double time_step = std::numeric_limits<double>::max();
+  for (unsigned int c=0; c<cell_clusters.size(); ++c)
+    time_step = std::min (time_step,
+                          scaling * admissible_time_steps[c] * std::ldexp (1., cell_clusters[c]));
+  return time_step;
+}
+
+
+
+template <int dim, int spacedim>
+double
+LocalTimeStepping<dim,spacedim>::update_ratio () const
+{
+  if (clusters.size() == 0)
+    return 1.;
+
+  // per time step of the coarsest cluster, cluster l takes 2^l steps
+  double local_updates = 0;
+  for (unsigned int l=0; l<clusters.size(); ++l)
+    local_updates += static_cast<double>(clusters[l].size()) * std::ldexp (1., l);
+  const double global_updates = static_cast<double>(cell_clusters.size()) *
+                                std::ldexp (1., static_cast<int>(clusters.size())-1);
+  return global_updates / local_updates;
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+advance (const double           time,
+         const double           time_step,
+         const PredictFunction &predict,
+         const UpdateFunction  &update)
+{
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+  if (clusters.size() > 0)
+    advance_cluster (0, time, time_step, predict, update);
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+advance_cluster (const unsigned int     cluster,
+                 const double           time,
+                 const double           time_step,
+                 const PredictFunction &predict,
+                 const UpdateFunction  &update)
+{
+  const unsigned int n_cells = clusters[cluster].size();
+  parallel::apply_to_subranges (0U, n_cells,
+                                std_cxx11::bind (&LocalTimeStepping<dim,spacedim>::predict_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 cluster, time,
+                                                 std_cxx11::cref (predict)),
+                                16);
+
+  if (cluster+1 < clusters.size())
+    {
+      advance_cluster (cluster+1, time, time_step/2, predict, update);
+      advance_cluster (cluster+1, time+time_step/2, time_step/2, predict, update);
+    }
+
+  parallel::apply_to_subranges (0U, n_cells,
+                                std_cxx11::bind (&LocalTimeStepping<dim,spacedim>::update_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 cluster, time, time_step,
+                                                 std_cxx11::cref (update)),
+                                16);
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+predict_cells (const unsigned int     begin,
+               const unsigned int     end,
+               const unsigned int     cluster,
+               const double           time,
+               const PredictFunction &predict) const
+{
+  for (unsigned int c=begin; c<end; ++c)
+    predict (clusters[cluster][c], time);
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+update_cells (const unsigned int    begin,
+              const unsigned int    end,
+              const unsigned int    cluster,
+              const double          time,
+              const double          time_step,
+              const UpdateFunction &update) const
+{
+  for (unsigned int c=begin; c<end; ++c)
+    update (clusters[cluster][c], time, time_step);
+}
+
+
+
+template <int dim, int spacedim>
+bool
+LocalTimeStepping<dim,spacedim>::
+is_coarser_neighbor (const unsigned int cell,
+                     const unsigned int neighbor) const
+{
+  AssertIndexRange (cell, cell_clusters.size());
+  AssertIndexRange (neighbor, cell_clusters.size());
+  return (cell_clusters[neighbor] < cell_clusters[cell]);
+}
+
+
+
+template <int dim, int spacedim>
+Vector<double> &
+LocalTimeStepping<dim,spacedim>::
+interface_buffer (const unsigned int cell,
+                  const unsigned int neighbor)
+{
+  AssertIndexRange (cell, cell_clusters.size());
+  for (unsigned int n=connectivity.neighbor_start[cell]; n<connectivity.neighbor_start[cell+1]; ++n)
+    if (connectivity.neighbors[n] == neighbor)
+      {
+        Assert (interface_buffers[n].size() > 0,
+                ExcMessage ("The neighbor is not in a coarser cluster."));
+        return interface_buffers[n];
+      }
+
+  Assert (false, ExcMessage ("The cells are not face neighbors."));
+  return interface_buffers[0];
+}
+
+
+
+template <int dim, int spacedim>
+void
+LocalTimeStepping<dim,spacedim>::
+collect_interface_contributions (const unsigned int  cell,
+                                 Vector<double>     &contributions)
+{
+  AssertIndexRange (cell, cell_clusters.size());
+  for (unsigned int e=finer_neighbor_start[cell]; e<finer_neighbor_start[cell+1]; ++e)
+    {
+      Vector<double> &buffer = interface_buffers[finer_neighbor_entries[e]];
+      contributions += buffer;
+      buffer = 0;
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_local_time_stepping.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
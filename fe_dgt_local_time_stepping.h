@@ -0,0 +1,254 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_local_time_stepping_h
+#define dealii__fe_dgt_local_time_stepping_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A scheduler for local time stepping of explicit discontinuous Galerkin
+ * schemes, in particular of the one-step ADER schemes built on
+ * ADERPredictor, on meshes with cells of very different sizes.
+ *
+ * The active cells are grouped into clusters $l=0,1,\dots$ advanced with
+ * the time steps $\Delta t/2^l$, where $\Delta t$ is the time step of the
+ * coarsest cluster. A cell is put into the coarsest cluster whose time step
+ * does not exceed its admissible time step, which by default is taken
+ * proportional to its diameter. Clusters of face neighbors then differ by
+ * at most one, which is enforced by moving cells to finer clusters where
+ * necessary.
+ *
+ * advance() performs one time step $\Delta t$ of the coarsest cluster by
+ * the recursion
+ * <ol>
+ * <li> call the predict function on all cells of cluster $l$ at the
+ *      current time of the cluster,
+ * <li> advance cluster $l+1$ twice with half the time step,
+ * <li> call the update function on all cells of cluster $l$.
+ * </ol>
+ * Hence, while a cluster takes its substeps, the cells of the next coarser
+ * cluster have been predicted but not yet updated, and the fine cells can
+ * evaluate the coarse predictors at their own times. Within each phase,
+ * the cells of a cluster are processed in parallel.
+ *
+ * For conservation, the flux across the interface between a fine cell and
+ * a coarser neighbor must be the same on both sides. Therefore, the update
+ * function of a fine cell adds the time integral over its substep of the
+ * flux contribution to the residual of the coarse neighbor into the buffer
+ * returned by interface_buffer(). When the coarse cell is updated, it
+ * obtains the sum over all substeps from collect_interface_contributions()
+ * and uses it instead of computing the flux across these faces itself.
+ * Since each buffer is only written by the fine cell it belongs to, no
+ * synchronization is needed.
+ *
+ * The number of cell updates per unit of simulated time is reduced by the
+ * factor returned by update_ratio() compared to global time stepping with
+ * the time step of the finest cluster.
+ */
+template <int dim, int spacedim=dim>
+class LocalTimeStepping : public Subscriptor
+{
+public:
+  /**
+   * The function called to predict the solution on the cell with the given
+   * active_cell_index() at the beginning of a time step of its cluster
+   * starting at the given time.
+   */
+  typedef std_cxx11::function<void (const unsigned int, const double)> PredictFunction;
+
+  /**
+   * The function called to advance the solution on the cell with the given
+   * active_cell_index() from the given time by the given time step.
+   */
+  typedef std_cxx11::function<void (const unsigned int, const double, const double)> UpdateFunction;
+
+  /**
+   * Constructor. At most @p max_n_clusters clusters are formed. Calls
+   * reinit().
+   */
+  LocalTimeStepping (const DoFHandler<dim,spacedim> &dof_handler,
+                     const unsigned int              max_n_clusters = 16);
+
+  /**
+   * Form the clusters with admissible time steps proportional to the cell
+   * diameters. Must be called again whenever the mesh changes.
+   */
+  void reinit ();
+
+  /**
+   * Form the clusters with the given admissible time steps of the active
+   * cells, indexed by active_cell_index(). Only their ratios matter. The
+   * neighbor lists are rebuilt from the DoFHandler as well, so this function
+   * may be called directly after the mesh has changed.
+   */
+  void reinit (const std::vector<double> &admissible_time_steps);
+
+  /**
+   * Return the number of clusters.
+   */
+  unsigned int n_clusters () const;
+
+  /**
+   * Return the cluster of the cell with the given active_cell_index().
+   */
+  unsigned int cluster_of_cell (const unsigned int cell) const;
+
+  /**
+   * Return the active_cell_index() of the cells in @p cluster.
+   */
+  const std::vector<unsigned int> &
+  cells_in_cluster (const unsigned int cluster) const;
+
+  /**
+   * Return the largest time step of the coarsest cluster for which all
+   * cells obey their admissible time step, where the admissible time steps
+   * passed to reinit() (or the cell diameters) are multiplied by
+   * @p scaling, e.g., by the CFL number divided by the maximal wave speed.
+   */
+  double max_time_step (const double scaling = 1.) const;
+
+  /**
+   * Return the number of cell updates of global time stepping with the
+   * time step of the finest cluster divided by those of local time
+   * stepping over the same time interval.
+   */
+  double update_ratio () const;
+
+  /**
+   * Advance all cells from @p time by @p time_step, the time step of the
+   * coarsest cluster, as described in the documentation of this class.
+   */
+  void advance (const double           time,
+                const double           time_step,
+                const PredictFunction &predict,
+                const UpdateFunction  &update);
+
+  /**
+   * Return whether the cell with active_cell_index() @p neighbor is a face
+   * neighbor of @p cell in a coarser cluster.
+   */
+  bool is_coarser_neighbor (const unsigned int cell,
+                            const unsigned int neighbor) const;
+
+  /**
+   * Return the buffer into which the update function of @p cell adds its
+   * contributions to the residual of its coarser neighbor @p neighbor, see
+   * the documentation of this class. The buffer has one entry per degree
+   * of freedom of a cell.
+   */
+  Vector<double> &
+  interface_buffer (const unsigned int cell,
+                    const unsigned int neighbor);
+
+  /**
+   * Add the contributions accumulated by the finer neighbors of @p cell
+   * to @p contributions and reset their buffers.
+   */
+  void collect_interface_contributions (const unsigned int  cell,
+                                        Vector<double>     &contributions);
+
+private:
+  /**
+   * Advance @p cluster and, recursively, all finer clusters.
+   */
+  void advance_cluster (const unsigned int     cluster,
+                        const double           time,
+                        const double           time_step,
+                        const PredictFunction &predict,
+                        const UpdateFunction  &update);
+
+  /**
+   * Call @p predict on the cells <tt>[begin,end)</tt> of @p cluster.
+   */
+  void predict_cells (const unsigned int     begin,
+                      const unsigned int     end,
+                      const unsigned int     cluster,
+                      const double           time,
+                      const PredictFunction &predict) const;
+
+  /**
+   * Call @p update on the cells <tt>[begin,end)</tt> of @p cluster.
+   */
+  void update_cells (const unsigned int    begin,
+                     const unsigned int    end,
+                     const unsigned int    cluster,
+                     const double          time,
+                     const double          time_step,
+                     const UpdateFunction &update) const;
+
+  /**
+   * The DoFHandler the solution lives on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,LocalTimeStepping<dim,spacedim> > dof_handler;
+
+  /**
+   * The maximal number of clusters.
+   */
+  const unsigned int max_n_clusters;
+
+  /**
+   * The active cells and their face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The admissible time step of each cell, see reinit().
+   */
+  std::vector<double> admissible_time_steps;
+
+  /**
+   * The cluster of each cell.
+   */
+  std::vector<unsigned int> cell_clusters;
+
+  /**
+   * The cells of each cluster.
+   */
+  std::vector<std::vector<unsigned int> > clusters;
+
+  /**
+   * One buffer for each entry of the neighbor lists of #connectivity whose
+   * neighbor is in a coarser cluster, and an empty vector otherwise.
+   */
+  std::vector<Vector<double> > interface_buffers;
+
+  /**
+   * The entries of the neighbor lists that point to a cell from a finer
+   * neighbor, in compressed row format like the neighbor lists.
+   */
+  std::vector<unsigned int> finer_neighbor_start;
+  std::vector<unsigned int> finer_neighbor_entries;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
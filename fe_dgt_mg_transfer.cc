@@ -0,0 +1,308 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_mg_transfer.h>
+
+#include <cmath>
+#include <map>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::build (const DoFHandler<dim,spacedim> &dof_handler)
+{
+  const FE_DGT<dim,spacedim> *fe
+    = dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe());
+  AssertThrow (fe != 0 && fe->n_components() == 1,
+               ExcMessage ("The transfer requires a scalar FE_DGT element."));
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const unsigned int max_children = GeometryInfo<dim>::max_children_per_cell;
+
+  const unsigned int n_levels = dof_handler.get_triangulation().n_levels();
+  level_sizes.resize (n_levels);
+  for (unsigned int level=0; level<n_levels; ++level)
+    level_sizes[level] = dof_handler.n_dofs (level);
+
+  // the matrices are identified by the relative offset and size of the
+  // child, rounded so that children that are copies of each other up to
+  // roundoff share a matrix
+  const double tolerance = 1e-10;
+  std::map<std::vector<double>, unsigned int> matrix_map;
+  prolongation_matrices.clear ();
+  std::vector<double> key (dim+1);
+  FullMatrix<double> matrix;
+
+  level_data.resize (n_levels > 0 ? n_levels-1 : 0);
+  std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+  for (unsigned int level=0; level+1<n_levels; ++level)
+    {
+      LevelData &data = level_data[level];
+
+      unsigned int n_parents = 0;
+      for (typename DoFHandler<dim,spacedim>::level_cell_iterator
+           cell = dof_handler.begin(level); cell != dof_handler.end(level); ++cell)
+        if (cell->has_children())
+          ++n_parents;
+
+      data.parent_dofs.reinit (n_parents, dofs_per_cell);
+      data.child_dofs.reinit (n_parents*max_children, dofs_per_cell);
+      data.n_children.resize (n_parents);
+      data.matrix_indices.reinit (n_parents, max_children);
+
+      unsigned int p = 0;
+      for (typename DoFHandler<dim,spacedim>::level_cell_iterator
+           cell = dof_handler.begin(level); cell != dof_handler.end(level); ++cell)
+        if (cell->has_children())
+          {
+            cell->get_mg_dof_indices (dof_indices);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              data.parent_dofs(p,i) = dof_indices[i];
+
+            const double h = cell->diameter();
+            const Point<spacedim> center = cell->center();
+            data.n_children[p] = cell->n_children();
+            for (unsigned int c=0; c<cell->n_children(); ++c)
+              {
+                const typename DoFHandler<dim,spacedim>::level_cell_iterator child = cell->child(c);
+                child->get_mg_dof_indices (dof_indices);
+                for (unsigned int i=0; i<dofs_per_cell; ++i)
+                  data.child_dofs(p*max_children+c,i) = dof_indices[i];
+
+                const double child_h = child->diameter();
+                const Point<spacedim> child_center = child->center();
+                key[0] = std::floor (child_h/h/tolerance + 0.5);
+                for (unsigned int d=0; d<dim; ++d)
+                  key[d+1] = std::floor ((child_center[d]-center[d])/h/tolerance + 0.5);
+
+                const std::map<std::vector<double>, unsigned int>::const_iterator
+                entry = matrix_map.find (key);
+                if (entry != matrix_map.end())
+                  data.matrix_indices(p,c) = entry->second;
+                else
+                  {
+                    fe->get_reexpansion_matrix (center, h, child_center, child_h, matrix);
+                    data.matrix_indices(p,c) = prolongation_matrices.size();
+                    matrix_map[key] = prolongation_matrices.size();
+                    prolongation_matrices.push_back (matrix);
+                  }
+              }
+            ++p;
+          }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+prolongate (const unsigned int    to_level,
+            Vector<double>       &dst,
+            const Vector<double> &src) const
+{
+  Assert (to_level > 0 && to_level <= level_data.size(),
+          ExcIndexRange (to_level, 1, level_data.size()+1));
+  AssertDimension (dst.size(), level_sizes[to_level]);
+  AssertDimension (src.size(), level_sizes[to_level-1]);
+
+  // every cell of the finer level is the child of a parent on the coarser
+  // one, so each entry of dst is set exactly once
+  parallel::apply_to_subranges (0U, level_data[to_level-1].n_children.size(),
+                                std_cxx11::bind (&MGTransferDGT<dim,spacedim>::prolongate_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 to_level,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+prolongate_cells (const unsigned int    begin,
+                  const unsigned int    end,
+                  const unsigned int    to_level,
+                  Vector<double>       &dst,
+                  const Vector<double> &src) const
+{
+  const LevelData &data = level_data[to_level-1];
+  const unsigned int dofs_per_cell = data.parent_dofs.size(1);
+  const unsigned int max_children = GeometryInfo<dim>::max_children_per_cell;
+  Vector<double> parent_values (dofs_per_cell);
+  Vector<double> child_values (dofs_per_cell);
+  for (unsigned int p=begin; p<end; ++p)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        parent_values(i) = src(data.parent_dofs(p,i));
+      for (unsigned int c=0; c<data.n_children[p]; ++c)
+        {
+          prolongation_matrices[data.matrix_indices(p,c)].vmult (child_values, parent_values);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            dst(data.child_dofs(p*max_children+c,i)) = child_values(i);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+restrict_and_add (const unsigned int    from_level,
+                  Vector<double>       &dst,
+                  const Vector<double> &src) const
+{
+  Assert (from_level > 0 && from_level <= level_data.size(),
+          ExcIndexRange (from_level, 1, level_data.size()+1));
+  AssertDimension (dst.size(), level_sizes[from_level-1]);
+  AssertDimension (src.size(), level_sizes[from_level]);
+
+  parallel::apply_to_subranges (0U, level_data[from_level-1].n_children.size(),
+                                std_cxx11::bind (&MGTransferDGT<dim,spacedim>::restrict_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 from_level,
+                                                 std_cxx11::ref (dst),
+                                                 std_cxx11::cref (src)),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+restrict_cells (const unsigned int    begin,
+                const unsigned int    end,
+                const unsigned int    from_level,
+                Vector<double>       &dst,
+                const Vector<double> &src) const
+{
+  const LevelData &data = level_data[from_level-1];
+  const unsigned int dofs_per_cell = data.parent_dofs.size(1);
+  const unsigned int max_children = GeometryInfo<dim>::max_children_per_cell;
+  Vector<double> parent_values (dofs_per_cell);
+  Vector<double> child_values (dofs_per_cell);
+  for (unsigned int p=begin; p<end; ++p)
+    {
+      for (unsigned int c=0; c<data.n_children[p]; ++c)
+        {
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            child_values(i) = src(data.child_dofs(p*max_children+c,i));
+          prolongation_matrices[data.matrix_indices(p,c)].Tvmult_add (parent_values, child_values);
+        }
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        dst(data.parent_dofs(p,i)) += parent_values(i);
+      parent_values = 0;
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+copy_to_mg (const DoFHandler<dim,spacedim>   &dof_handler,
+            MGLevelObject<Vector<double> >   &dst,
+            const Vector<double>             &src) const
+{
+  AssertDimension (src.size(), dof_handler.n_dofs());
+  dst.resize (0, level_sizes.size()-1);
+  for (unsigned int level=0; level<level_sizes.size(); ++level)
+    dst[level].reinit (level_sizes[level]);
+
+  const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+  std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+  std::vector<types::global_dof_index> level_dof_indices (dofs_per_cell);
+  for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (dof_indices);
+      cell->get_mg_dof_indices (level_dof_indices);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        dst[cell->level()](level_dof_indices[i]) = src(dof_indices[i]);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGTransferDGT<dim,spacedim>::
+copy_from_mg (const DoFHandler<dim,spacedim>       &dof_handler,
+              Vector<double>                       &dst,
+              const MGLevelObject<Vector<double> > &src) const
+{
+  AssertDimension (dst.size(), dof_handler.n_dofs());
+
+  const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+  std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+  std::vector<types::global_dof_index> level_dof_indices (dofs_per_cell);
+  for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (dof_indices);
+      cell->get_mg_dof_indices (level_dof_indices);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        dst(dof_indices[i]) = src[cell->level()](level_dof_indices[i]);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+MGTransferDGT<dim,spacedim>::n_prolongation_matrices () const
+{
+  return prolongation_matrices.size();
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+MGTransferDGT<dim,spacedim>::memory_consumption () const
+{
+  std::size_t memory = (MemoryConsumption::memory_consumption (prolongation_matrices) +
+                        MemoryConsumption::memory_consumption (level_sizes));
+  for (unsigned int l=0; l<level_data.size(); ++l)
+    memory += (MemoryConsumption::memory_consumption (level_data[l].parent_dofs) +
+               MemoryConsumption::memory_consumption (level_data[l].child_dofs) +
+               MemoryConsumption::memory_consumption (level_data[l].n_children) +
+               MemoryConsumption::memory_consumption (level_data[l].matrix_indices));
+  return memory;
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_mg_transfer.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
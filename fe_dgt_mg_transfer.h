@@ -0,0 +1,188 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_mg_transfer_h
+#define dealii__fe_dgt_mg_transfer_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * Transfer between the levels of a geometric multigrid method for the
+ * FE_DGT element.
+ *
+ * Since the shape functions of FE_DGT are monomials in the real
+ * coordinates scaled around the center of each cell, a polynomial on a
+ * parent cell is represented exactly on each child by re-expanding it
+ * around the center and diameter of the child, see
+ * FE_DGT::get_reexpansion_matrix(). These re-expansion matrices form the
+ * prolongation, and restriction is their transpose, so that the level
+ * matrices of a Galerkin method are consistent. Unlike the matrices of
+ * FiniteElement::get_prolongation_matrix(), which refer to the unit
+ * hypercube, the matrices are computed from the actual geometry of each
+ * parent and child.
+ *
+ * The matrices depend only on the offset of the center of the child from
+ * that of the parent and on the ratio of their diameters, both relative
+ * to the diameter of the parent. They are precomputed by build() once for
+ * each distinct pair of these quantities, which on meshes of similar
+ * cells is a small number, and the transfer applies them cell by cell in
+ * parallel over the parents.
+ *
+ * The class implements MGTransferBase and the functions copy_to_mg() and
+ * copy_from_mg() used by PreconditionMG. Since the element has no degrees
+ * of freedom shared between cells, the values of each active cell are
+ * copied to and from the level of the cell, which includes adaptively
+ * refined meshes.
+ *
+ * The DoFHandler must use a scalar FE_DGT element and have its level
+ * degrees of freedom distributed.
+ */
+template <int dim, int spacedim=dim>
+class MGTransferDGT : public MGTransferBase<Vector<double> >
+{
+public:
+  /**
+   * Compute the transfer matrices and collect the level degrees of
+   * freedom of all parents and children of @p dof_handler.
+   */
+  void build (const DoFHandler<dim,spacedim> &dof_handler);
+
+  /**
+   * Prolongate @p src on level <tt>to_level-1</tt> to @p dst on level
+   * @p to_level.
+   */
+  virtual void prolongate (const unsigned int    to_level,
+                           Vector<double>       &dst,
+                           const Vector<double> &src) const;
+
+  /**
+   * Restrict @p src on level @p from_level and add it to @p dst on level
+   * <tt>from_level-1</tt>.
+   */
+  virtual void restrict_and_add (const unsigned int    from_level,
+                                 Vector<double>       &dst,
+                                 const Vector<double> &src) const;
+
+  /**
+   * Copy the values of the active cells from @p src to the vectors of
+   * their levels in @p dst, setting all other entries to zero.
+   */
+  void copy_to_mg (const DoFHandler<dim,spacedim>   &dof_handler,
+                   MGLevelObject<Vector<double> >   &dst,
+                   const Vector<double>             &src) const;
+
+  /**
+   * Copy the values of the active cells from the vectors of their levels
+   * in @p src to @p dst.
+   */
+  void copy_from_mg (const DoFHandler<dim,spacedim>       &dof_handler,
+                     Vector<double>                       &dst,
+                     const MGLevelObject<Vector<double> > &src) const;
+
+  /**
+   * Return the number of distinct prolongation matrices.
+   */
+  unsigned int n_prolongation_matrices () const;
+
+  /**
+   * Memory consumption in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The parents on one level and their children on the next finer level.
+   */
+  struct LevelData
+  {
+    /**
+     * The level degrees of freedom of each parent.
+     */
+    Table<2,types::global_dof_index> parent_dofs;
+
+    /**
+     * The level degrees of freedom of child @p i of parent @p p, in row
+     * <tt>p*max_children_per_cell+i</tt>.
+     */
+    Table<2,types::global_dof_index> child_dofs;
+
+    /**
+     * The number of children of each parent.
+     */
+    std::vector<unsigned int> n_children;
+
+    /**
+     * The index in #prolongation_matrices of the matrix of child @p i of
+     * parent @p p.
+     */
+    Table<2,unsigned int> matrix_indices;
+  };
+
+  /**
+   * Prolongate on the parents <tt>[begin,end)</tt> of level
+   * <tt>to_level-1</tt>.
+   */
+  void prolongate_cells (const unsigned int    begin,
+                         const unsigned int    end,
+                         const unsigned int    to_level,
+                         Vector<double>       &dst,
+                         const Vector<double> &src) const;
+
+  /**
+   * Restrict to the parents <tt>[begin,end)</tt> of level
+   * <tt>from_level-1</tt>.
+   */
+  void restrict_cells (const unsigned int    begin,
+                       const unsigned int    end,
+                       const unsigned int    from_level,
+                       Vector<double>       &dst,
+                       const Vector<double> &src) const;
+
+  /**
+   * The parents and children between level @p l and <tt>l+1</tt>, in
+   * entry @p l.
+   */
+  std::vector<LevelData> level_data;
+
+  /**
+   * The distinct prolongation matrices.
+   */
+  std::vector<FullMatrix<double> > prolongation_matrices;
+
+  /**
+   * The number of degrees of freedom of each level.
+   */
+  std::vector<types::global_dof_index> level_sizes;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,216 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_dgt_moment_limiter.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+MomentLimiter<dim,spacedim>::
+MomentLimiter (const DoFHandler<dim,spacedim> &dof_handler)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  fe (dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe()),
+      typeid(*this).name())
+{
+  AssertThrow (fe != 0,
+               ExcMessage ("The moment limiter requires an FE_DGT element."));
+
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const Table<2,unsigned int> &exponents = fe->get_monomial_exponents();
+
+  monomials_of_degree.resize (fe->degree+1);
+  raise_indices.reinit (dofs_per_cell, dim);
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    {
+      unsigned int monomial_degree = 0;
+      TableIndices<dim> powers;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          monomial_degree += exponents(i,d);
+          powers[d] = exponents(i,d);
+        }
+      monomials_of_degree[monomial_degree].push_back (i);
+
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          ++powers[d];
+          raise_indices(i,d) = fe->get_monomial_index (powers);
+          --powers[d];
+        }
+    }
+
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+MomentLimiter<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+}
+
+
+
+template <int dim, int spacedim>
+void
+MomentLimiter<dim,spacedim>::limit (Vector<double> &solution) const
+{
+  std::vector<unsigned int> cells (connectivity.n_cells());
+  for (unsigned int c=0; c<cells.size(); ++c)
+    cells[c] = c;
+  limit (solution, cells);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MomentLimiter<dim,spacedim>::
+limit (Vector<double>                  &solution,
+       const std::vector<unsigned int> &cells) const
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  // compute all limited coefficients before writing any of them back, since
+  // the bounds are taken from the neighbors
+  Table<2,double> new_coefficients (cells.size(), fe->dofs_per_cell);
+  parallel::apply_to_subranges (0U, static_cast<unsigned int>(cells.size()),
+                                std_cxx11::bind (&MomentLimiter<dim,spacedim>::limit_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (solution),
+                                                 std_cxx11::cref (cells),
+                                                 std_cxx11::ref (new_coefficients)),
+                                64);
+
+  for (unsigned int c=0; c<cells.size(); ++c)
+    for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+      solution(connectivity.dof_indices(cells[c],i)) = new_coefficients(c,i);
+}
+
+
+
+template <int dim, int spacedim>
+void
+MomentLimiter<dim,spacedim>::
+limit_cells (const unsigned int               begin,
+             const unsigned int               end,
+             const Vector<double>            &solution,
+             const std::vector<unsigned int> &cells,
+             Table<2,double>                 &new_coefficients) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const unsigned int degree = fe->degree;
+
+  Vector<double> coefficients (dofs_per_cell);
+  Vector<double> neighbor_coefficients (dofs_per_cell);
+  Vector<double> derivatives (dofs_per_cell);
+  Vector<double> neighbor_derivatives (dofs_per_cell);
+  Vector<double> min_derivatives (dofs_per_cell);
+  Vector<double> max_derivatives (dofs_per_cell);
+  std::vector<Tensor<1,spacedim> > vertex_offsets (GeometryInfo<dim>::vertices_per_cell);
+
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      const unsigned int index = cells[c];
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+        = connectivity.cells[index];
+      connectivity.get_coefficients (solution, index, coefficients);
+
+      fe->coefficients_to_center_derivatives (cell, coefficients, derivatives);
+      min_derivatives = derivatives;
+      max_derivatives = derivatives;
+
+      // bounds from the derivatives at the centers of the neighbors
+      for (unsigned int n=connectivity.neighbor_start[index];
+           n<connectivity.neighbor_start[index+1]; ++n)
+        {
+          const unsigned int neighbor_index = connectivity.neighbors[n];
+          connectivity.get_coefficients (solution, neighbor_index, neighbor_coefficients);
+          fe->coefficients_to_center_derivatives (connectivity.cells[neighbor_index],
+                                                  neighbor_coefficients,
+                                                  neighbor_derivatives);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            {
+              min_derivatives(i) = std::min (min_derivatives(i), neighbor_derivatives(i));
+              max_derivatives(i) = std::max (max_derivatives(i), neighbor_derivatives(i));
+            }
+        }
+
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        vertex_offsets[v] = cell->vertex(v) - cell->center();
+
+      const double average = fe->cell_average (shape_classes, cell, coefficients);
+
+      // limit the derivatives of order m through the linear reconstruction
+      // of those of order m-1, from the highest order downward
+      double previous_alpha = 0;
+      for (unsigned int m=degree; m>=1; --m)
+        {
+          double alpha = 1.;
+          for (unsigned int k=0; k<monomials_of_degree[m-1].size(); ++k)
+            {
+              const unsigned int i = monomials_of_degree[m-1][k];
+              for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                {
+                  double delta = 0;
+                  for (unsigned int d=0; d<dim; ++d)
+                    delta += derivatives(raise_indices(i,d)) * vertex_offsets[v][d];
+                  if (delta > 0)
+                    alpha = std::min (alpha, (max_derivatives(i) - derivatives(i)) / delta);
+                  else if (delta < 0)
+                    alpha = std::min (alpha, (min_derivatives(i) - derivatives(i)) / delta);
+                }
+            }
+          alpha = std::max (alpha, previous_alpha);
+
+          // lower orders would be limited with a factor at least as large
+          if (alpha >= 1.)
+            break;
+
+          for (unsigned int k=0; k<monomials_of_degree[m].size(); ++k)
+            coefficients(monomials_of_degree[m][k]) *= alpha;
+          previous_alpha = alpha;
+        }
+
+      // the constant shape function has mean value one
+      coefficients(0) += average - fe->cell_average (shape_classes, cell, coefficients);
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        new_coefficients(c,i) = coefficients(i);
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_moment_limiter.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
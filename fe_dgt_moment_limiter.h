@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_moment_limiter_h
+#define dealii__fe_dgt_moment_limiter_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/table.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A hierarchical moment limiter for discontinuous Galerkin solutions
+ * represented by the FE_DGT element, following the vertex-based
+ * hierarchical limiter of Kuzmin for Taylor bases, with the bounds taken
+ * from the face neighbors.
+ *
+ * The coefficient of shape function $\alpha$ on a cell with center $x_c$
+ * and diameter $h$ equals $D^\alpha u(x_c) h^{|\alpha|}/\alpha!$, so the
+ * derivatives of the solution at the cell centers are available without
+ * any evaluation. For each order $m=k,k-1,\ldots,1$, the limiter considers
+ * the linear Taylor polynomials
+ * @f[
+ *   D^\beta u(x_c) + \nabla D^\beta u(x_c) \cdot (x-x_c), \qquad |\beta|=m-1,
+ * @f]
+ * and determines the largest factor $\alpha_m\le 1$ such that these stay,
+ * at the vertices of the cell, within the range of $D^\beta u$ at the
+ * centers of the cell and its face neighbors. The coefficients of order $m$
+ * are then multiplied by $\max(\alpha_m,\alpha_{m+1})$, so that lower
+ * derivatives are never limited more than higher ones. Processing stops at
+ * the first order that needs no limiting. Since the monomials of positive
+ * degree do not have mean value zero in general, the constant coefficient
+ * is finally corrected so that the mean value on the cell is preserved.
+ *
+ * All operations act on the coefficients of a cell and its neighbors
+ * only, and the cells are processed in parallel. Neighbor data are always
+ * taken from the solution before limiting.
+ */
+template <int dim, int spacedim=dim>
+class MomentLimiter : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Calls reinit().
+   */
+  MomentLimiter (const DoFHandler<dim,spacedim> &dof_handler);
+
+  /**
+   * Set up the connectivity table and the indices of degrees of freedom of
+   * all active cells. Must be called again whenever the mesh or the
+   * numbering of degrees of freedom changes.
+   */
+  void reinit ();
+
+  /**
+   * Limit all active cells.
+   */
+  void limit (Vector<double> &solution) const;
+
+  /**
+   * Limit the cells whose active_cell_index() is listed in @p cells.
+   */
+  void limit (Vector<double>                  &solution,
+              const std::vector<unsigned int> &cells) const;
+
+private:
+  /**
+   * Compute the limited coefficients of the cells with indices
+   * <tt>[begin,end)</tt> in @p cells into the corresponding rows of
+   * @p new_coefficients.
+   */
+  void limit_cells (const unsigned int               begin,
+                    const unsigned int               end,
+                    const Vector<double>            &solution,
+                    const std::vector<unsigned int> &cells,
+                    Table<2,double>                 &new_coefficients) const;
+
+  /**
+   * The DoFHandler the solution vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,MomentLimiter<dim,spacedim> > dof_handler;
+
+  /**
+   * The finite element of #dof_handler.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,MomentLimiter<dim,spacedim> > fe;
+
+  /**
+   * The active cells with their degrees of freedom and face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+
+  /**
+   * The shape functions of each total degree.
+   */
+  std::vector<std::vector<unsigned int> > monomials_of_degree;
+
+  /**
+   * <tt>raise_indices(i,d)</tt> is the index of the shape function whose
+   * exponents are those of shape function @p i with the one of direction
+   * @p d increased by one, or numbers::invalid_unsigned_int if that
+   * exceeds the degree of the element.
+   */
+  Table<2,unsigned int> raise_indices;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
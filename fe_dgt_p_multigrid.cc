@@ -0,0 +1,236 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/fe/fe_dgt_p_multigrid.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+PMultigrid<dim,spacedim>::AdditionalData::
+AdditionalData (const unsigned int n_smoothing_steps,
+                const double       relaxation,
+                const unsigned int n_coarse_iterations)
+  :
+  n_smoothing_steps (n_smoothing_steps),
+  relaxation (relaxation),
+  n_coarse_iterations (n_coarse_iterations)
+{}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+            const FE_DGT<dim,spacedim>                &fe,
+            const AdditionalData                      &additional_data)
+{
+  AssertDimension (matrix.block_size(), fe.dofs_per_cell);
+  this->additional_data = additional_data;
+  this->matrix = &matrix;
+
+  // release the smoothers before the matrices they point to
+  smoothers.clear ();
+  level_matrices.clear ();
+
+  const unsigned int degree = fe.degree;
+  const Table<2,unsigned int> &exponents = fe.get_monomial_exponents();
+  std::vector<unsigned int> monomial_degrees (fe.dofs_per_cell, 0);
+  for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+    for (unsigned int d=0; d<dim; ++d)
+      monomial_degrees[i] += exponents(i,d);
+
+  // the shape functions of FE_DGT(l) within FE_DGT(k), and within
+  // FE_DGT(l+1)
+  level_matrices.resize (degree);
+  selected_dofs.resize (degree+1);
+  for (unsigned int level=0; level<degree; ++level)
+    {
+      std::vector<unsigned int> dofs;
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (monomial_degrees[i] <= level)
+          dofs.push_back (i);
+      level_matrices[level].reset (new CellBlockSparseMatrix<dim,spacedim>());
+      level_matrices[level]->reinit (matrix, dofs);
+
+      unsigned int position = 0;
+      selected_dofs[level+1].clear ();
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (monomial_degrees[i] <= level+1)
+          {
+            if (monomial_degrees[i] <= level)
+              selected_dofs[level+1].push_back (position);
+            ++position;
+          }
+    }
+
+  smoothers.resize (degree+1);
+  for (unsigned int level=1; level<=degree; ++level)
+    {
+      smoothers[level].reset (new CellBlockJacobi<dim,spacedim>());
+      smoothers[level]->initialize (get_matrix (level));
+    }
+  coarse_preconditioner.initialize (get_matrix (0));
+
+  level_solution.resize (degree+1);
+  level_rhs.resize (degree+1);
+  level_residual.resize (degree+1);
+  level_update.resize (degree+1);
+  for (unsigned int level=0; level<=degree; ++level)
+    {
+      const unsigned int size = get_matrix (level).m();
+      level_solution[level].reinit (size);
+      level_rhs[level].reinit (size);
+      level_residual[level].reinit (size);
+      level_update[level].reinit (size);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+PMultigrid<dim,spacedim>::n_levels () const
+{
+  return level_matrices.size() + 1;
+}
+
+
+
+template <int dim, int spacedim>
+const CellBlockSparseMatrix<dim,spacedim> &
+PMultigrid<dim,spacedim>::get_matrix (const unsigned int level) const
+{
+  AssertIndexRange (level, n_levels());
+  if (level == level_matrices.size())
+    return *matrix;
+  return *level_matrices[level];
+}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+vmult (Vector<double>       &dst,
+       const Vector<double> &src) const
+{
+  AssertDimension (dst.size(), matrix->m());
+  AssertDimension (src.size(), matrix->n());
+  v_cycle (n_levels()-1, dst, src);
+}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+v_cycle (const unsigned int    level,
+         Vector<double>       &solution,
+         const Vector<double> &rhs) const
+{
+  solution = 0;
+  if (level == 0)
+    {
+      smooth (0, additional_data.n_coarse_iterations, solution, rhs);
+      return;
+    }
+
+  smooth (level, additional_data.n_smoothing_steps, solution, rhs);
+
+  // coarse grid correction with the truncated residual
+  Vector<double> &residual = level_residual[level];
+  get_matrix (level).vmult (residual, solution);
+  residual.sadd (-1., 1., rhs);
+  restrict_residual (level, residual, level_rhs[level-1]);
+  v_cycle (level-1, level_solution[level-1], level_rhs[level-1]);
+  prolongate_add (level, level_solution[level-1], solution);
+
+  smooth (level, additional_data.n_smoothing_steps, solution, rhs);
+}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+smooth (const unsigned int    level,
+        const unsigned int    n_steps,
+        Vector<double>       &solution,
+        const Vector<double> &rhs) const
+{
+  const CellBlockSparseMatrix<dim,spacedim> &level_matrix = get_matrix (level);
+  Vector<double> &residual = level_residual[level];
+  Vector<double> &update = level_update[level];
+  for (unsigned int step=0; step<n_steps; ++step)
+    {
+      level_matrix.vmult (residual, solution);
+      residual.sadd (-1., 1., rhs);
+      if (level == 0)
+        {
+          coarse_preconditioner.vmult (update, residual);
+          solution += update;
+        }
+      else
+        {
+          smoothers[level]->vmult (update, residual);
+          solution.add (additional_data.relaxation, update);
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+restrict_residual (const unsigned int    level,
+                   const Vector<double> &fine,
+                   Vector<double>       &coarse) const
+{
+  const Table<2,types::global_dof_index> &fine_dofs = get_matrix (level).connectivity.dof_indices;
+  const Table<2,types::global_dof_index> &coarse_dofs = get_matrix (level-1).connectivity.dof_indices;
+  const std::vector<unsigned int> &selected = selected_dofs[level];
+  for (unsigned int c=0; c<fine_dofs.size(0); ++c)
+    for (unsigned int i=0; i<selected.size(); ++i)
+      coarse(coarse_dofs(c,i)) = fine(fine_dofs(c,selected[i]));
+}
+
+
+
+template <int dim, int spacedim>
+void
+PMultigrid<dim,spacedim>::
+prolongate_add (const unsigned int    level,
+                const Vector<double> &coarse,
+                Vector<double>       &fine) const
+{
+  const Table<2,types::global_dof_index> &fine_dofs = get_matrix (level).connectivity.dof_indices;
+  const Table<2,types::global_dof_index> &coarse_dofs = get_matrix (level-1).connectivity.dof_indices;
+  const std::vector<unsigned int> &selected = selected_dofs[level];
+  for (unsigned int c=0; c<fine_dofs.size(0); ++c)
+    for (unsigned int i=0; i<selected.size(); ++i)
+      fine(fine_dofs(c,selected[i])) += coarse(coarse_dofs(c,i));
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_p_multigrid.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,199 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_p_multigrid_h
+#define dealii__fe_dgt_p_multigrid_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_block_sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A p-multigrid preconditioner for CellBlockSparseMatrix systems
+ * discretized with the FE_DGT element of degree $k$, with one level for
+ * each degree $l=k,k-1,\ldots,0$.
+ *
+ * The shape functions of FE_DGT are monomials of the scaled coordinates,
+ * so the shape functions of FE_DGT($l$) are exactly those of FE_DGT($k$)
+ * of total degree at most $l$, in the same relative order. Prolongation
+ * from level $l-1$ to level $l$ is therefore zero-padding of the
+ * coefficients of each cell and restriction is truncation, i.e., both are
+ * index selections without transfer matrices. The level matrices are the
+ * Galerkin products $R A P$, which are the submatrices of the selected
+ * shape functions in each block, see CellBlockSparseMatrix::reinit(). The
+ * coefficients are not a prefix of those of the next level in more than
+ * one dimension, since PolynomialSpace does not enumerate the monomials
+ * by degree, so the selected indices are stored for each level.
+ *
+ * vmult() performs one V-cycle with zero initial guess. The smoother on
+ * all levels but the coarsest is damped cell-block Jacobi with the cached
+ * inverse diagonal blocks of CellBlockJacobi. The coarsest level is
+ * FE_DGT(0), a finite volume discretization with one unknown per cell,
+ * which is solved approximately by a fixed number of Richardson
+ * iterations preconditioned with CellBlockILU. All operations are linear,
+ * and with equal numbers of pre- and post-smoothing steps the
+ * preconditioner is symmetric for symmetric matrices.
+ */
+template <int dim, int spacedim=dim>
+class PMultigrid : public Subscriptor
+{
+public:
+  /**
+   * Parameters of the preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const unsigned int n_smoothing_steps   = 2,
+                    const double       relaxation          = 0.7,
+                    const unsigned int n_coarse_iterations = 10);
+
+    /**
+     * The number of pre- and post-smoothing steps on each level.
+     */
+    unsigned int n_smoothing_steps;
+
+    /**
+     * The damping factor of the block Jacobi smoother.
+     */
+    double relaxation;
+
+    /**
+     * The number of ILU preconditioned Richardson iterations on the
+     * coarsest level.
+     */
+    unsigned int n_coarse_iterations;
+  };
+
+  /**
+   * Build the level matrices and smoothers for @p matrix, which must be
+   * set up for a DoFHandler with the element @p fe.
+   */
+  void initialize (const CellBlockSparseMatrix<dim,spacedim> &matrix,
+                   const FE_DGT<dim,spacedim>                &fe,
+                   const AdditionalData                      &additional_data = AdditionalData());
+
+  /**
+   * Apply one V-cycle to @p src. The vectors of the levels are stored in
+   * this object, so different threads must not call this function on the
+   * same object concurrently.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+  /**
+   * Return the number of levels, i.e., the degree of the element plus
+   * one.
+   */
+  unsigned int n_levels () const;
+
+private:
+  /**
+   * Return the matrix of the given level.
+   */
+  const CellBlockSparseMatrix<dim,spacedim> &get_matrix (const unsigned int level) const;
+
+  /**
+   * Perform a V-cycle on @p level and the coarser levels, starting with
+   * zero.
+   */
+  void v_cycle (const unsigned int    level,
+                Vector<double>       &solution,
+                const Vector<double> &rhs) const;
+
+  /**
+   * Perform @p n_steps damped block Jacobi or, on the coarsest level, ILU
+   * preconditioned Richardson steps on @p level.
+   */
+  void smooth (const unsigned int    level,
+               const unsigned int    n_steps,
+               Vector<double>       &solution,
+               const Vector<double> &rhs) const;
+
+  /**
+   * Truncate the vector @p fine of level <tt>level</tt> to @p coarse on
+   * level <tt>level-1</tt>.
+   */
+  void restrict_residual (const unsigned int    level,
+                          const Vector<double> &fine,
+                          Vector<double>       &coarse) const;
+
+  /**
+   * Add the zero-padded vector @p coarse of level <tt>level-1</tt> to
+   * @p fine on level @p level.
+   */
+  void prolongate_add (const unsigned int    level,
+                       const Vector<double> &coarse,
+                       Vector<double>       &fine) const;
+
+  /**
+   * The parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The matrix of the finest level.
+   */
+  SmartPointer<const CellBlockSparseMatrix<dim,spacedim>,PMultigrid<dim,spacedim> > matrix;
+
+  /**
+   * The matrices of the levels below the finest one.
+   */
+  std::vector<std_cxx11::shared_ptr<CellBlockSparseMatrix<dim,spacedim> > > level_matrices;
+
+  /**
+   * For each level <tt>l>0</tt>, the indices within the cell on level
+   * @p l of the shape functions of level <tt>l-1</tt>.
+   */
+  std::vector<std::vector<unsigned int> > selected_dofs;
+
+  /**
+   * The smoothers of the levels above the coarsest one.
+   */
+  std::vector<std_cxx11::shared_ptr<CellBlockJacobi<dim,spacedim> > > smoothers;
+
+  /**
+   * The preconditioner of the coarsest level.
+   */
+  CellBlockILU<dim,spacedim> coarse_preconditioner;
+
+  /**
+   * The solution, right hand side and temporary vectors of the levels.
+   */
+  mutable std::vector<Vector<double> > level_solution;
+  mutable std::vector<Vector<double> > level_rhs;
+  mutable std::vector<Vector<double> > level_residual;
+  mutable std::vector<Vector<double> > level_update;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
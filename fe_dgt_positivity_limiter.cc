@@ -0,0 +1,185 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/fe/fe_dgt_positivity_limiter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+PositivityLimiter<dim,spacedim>::
+PositivityLimiter (const DoFHandler<dim,spacedim> &dof_handler,
+                   const Quadrature<dim>          &quadrature,
+                   const unsigned int              component,
+                   const double                    epsilon)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  quadrature (quadrature),
+  epsilon (epsilon)
+{
+  const FiniteElement<dim,spacedim> &system_fe = dof_handler.get_fe();
+  AssertIndexRange (component, system_fe.n_components());
+
+  const unsigned int base = system_fe.component_to_base_index(component).first;
+  fe = dynamic_cast<const FE_DGT<dim,spacedim>*>(&system_fe.base_element(base));
+  AssertThrow (fe != 0,
+               ExcMessage ("The positivity limiter requires an FE_DGT element "
+                           "in the limited component."));
+
+  component_dofs.resize (fe->dofs_per_cell);
+  for (unsigned int i=0; i<system_fe.dofs_per_cell; ++i)
+    if (system_fe.system_to_component_index(i).first == component)
+      component_dofs[system_fe.system_to_component_index(i).second] = i;
+
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+PositivityLimiter<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+PositivityLimiter<dim,spacedim>::limit (Vector<double> &solution) const
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  // each cell only reads and writes its own coefficients, so the cells can
+  // be limited in place
+  return parallel::accumulate_from_subranges<unsigned int>
+         (std_cxx11::bind (&PositivityLimiter<dim,spacedim>::limit_cells,
+                           this,
+                           std_cxx11::_1, std_cxx11::_2,
+                           std_cxx11::ref (solution)),
+          0U, connectivity.n_cells(),
+          64);
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+PositivityLimiter<dim,spacedim>::
+limit_cells (const unsigned int  begin,
+             const unsigned int  end,
+             Vector<double>     &solution) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const Table<2,unsigned int> &exponents = fe->get_monomial_exponents();
+
+  Vector<double> coefficients (dofs_per_cell);
+  std::vector<double> values (quadrature.size());
+  Table<2,double> radius_powers (dim, fe->degree+1);
+
+  // the object for the fallback is only created when needed
+  std_cxx11::shared_ptr<FEValues<dim,spacedim> > fe_values;
+
+  unsigned int n_evaluated_cells = 0;
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+        = connectivity.cells[c];
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        coefficients(i) = solution(connectivity.dof_indices(c,component_dofs[i]));
+
+      // bound the polynomial from below on the bounding box of the cell in
+      // scaled coordinates
+      const double h = cell->diameter();
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          double radius = 0;
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            radius = std::max (radius, std::fabs (cell->vertex(v)[d] - cell->center()[d]) / h);
+          radius_powers(d,0) = 1.;
+          for (unsigned int e=1; e<=fe->degree; ++e)
+            radius_powers(d,e) = radius_powers(d,e-1) * radius;
+        }
+      double lower_bound = coefficients(0);
+      for (unsigned int i=1; i<dofs_per_cell; ++i)
+        {
+          double weight = std::fabs (coefficients(i));
+          for (unsigned int d=0; d<dim; ++d)
+            weight *= radius_powers(d,exponents(i,d));
+          lower_bound -= weight;
+        }
+      if (lower_bound >= epsilon)
+        continue;
+
+      // the bound failed, so evaluate the solution at the quadrature points
+      ++n_evaluated_cells;
+      if (fe_values.get() == 0)
+        fe_values.reset (new FEValues<dim,spacedim> (StaticMappingQ1<dim,spacedim>::mapping,
+                                                     *fe, quadrature, update_values));
+      fe_values->reinit (typename Triangulation<dim,spacedim>::cell_iterator (cell));
+
+      double min_value = std::numeric_limits<double>::max();
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        {
+          double value = 0;
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            value += coefficients(i) * fe_values->shape_value(i,q);
+          min_value = std::min (min_value, value);
+        }
+      if (min_value >= epsilon)
+        continue;
+
+      // scale the deviation from the mean value. if the mean value itself
+      // violates the bound, the best we can do is to keep only the mean
+      const double average = fe->cell_average (shape_classes, cell, coefficients);
+      const double theta = (average > epsilon
+                            ?
+                            std::min (1., (average - epsilon) / (average - min_value))
+                            :
+                            0.);
+
+      coefficients(0) = average + theta * (coefficients(0) - average);
+      for (unsigned int i=1; i<dofs_per_cell; ++i)
+        coefficients(i) *= theta;
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        solution(connectivity.dof_indices(c,component_dofs[i])) = coefficients(i);
+    }
+
+  return n_evaluated_cells;
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_positivity_limiter.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
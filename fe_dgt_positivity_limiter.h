@@ -0,0 +1,142 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_positivity_limiter_h
+#define dealii__fe_dgt_positivity_limiter_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * The positivity preserving limiter of Zhang and Shu for discontinuous
+ * Galerkin solutions represented by the FE_DGT element, for instance for
+ * the density in the Euler equations or the water depth in the shallow
+ * water equations.
+ *
+ * On each cell, the solution $u$ is replaced by
+ * $\bar u + \theta (u-\bar u)$ with the largest $\theta\in[0,1]$ such that
+ * the result is at least $\varepsilon$ at the points of a given quadrature
+ * formula, mapped to the cell. Here, $\bar u$ is the mean value on the
+ * cell, which is preserved.
+ *
+ * Most cells do not need limiting, and this can usually be decided without
+ * evaluating the solution: on a cell with center $x_c$ and diameter $h$,
+ * the scaled coordinates $\hat x = (x-x_c)/h$ satisfy
+ * $|\hat x_d| \le r_d$, where $r_d$ is the largest distance of a vertex
+ * from the center in direction $d$, divided by $h$. Hence
+ * @f[
+ *   u(x) \ge c_0 - \sum_{\alpha\neq 0} |c_\alpha| \, r^\alpha
+ * @f]
+ * on the whole cell, and if this bound is at least $\varepsilon$, the cell
+ * is skipped. Only on the remaining cells is the solution evaluated at the
+ * quadrature points, using an FEValues object with a $d$-linear mapping.
+ *
+ * The DoFHandler may either use an FE_DGT element or an FESystem whose
+ * base element is an FE_DGT element, in which case the component to be
+ * limited is selected in the constructor. Cells are processed in parallel.
+ */
+template <int dim, int spacedim=dim>
+class PositivityLimiter : public Subscriptor
+{
+public:
+  /**
+   * Constructor. The positivity of the solution is enforced at the points
+   * of @p quadrature, usually a combination of the quadrature formulas used
+   * on cells and faces. Calls reinit().
+   */
+  PositivityLimiter (const DoFHandler<dim,spacedim> &dof_handler,
+                     const Quadrature<dim>          &quadrature,
+                     const unsigned int              component = 0,
+                     const double                    epsilon   = 1e-13);
+
+  /**
+   * Set up the indices of degrees of freedom of all active cells. Must be
+   * called again whenever the mesh or the numbering of degrees of freedom
+   * changes.
+   */
+  void reinit ();
+
+  /**
+   * Limit all active cells. Return the number of cells on which the
+   * solution had to be evaluated since the bound from the coefficients
+   * failed.
+   */
+  unsigned int limit (Vector<double> &solution) const;
+
+private:
+  /**
+   * Limit the active cells with indices <tt>[begin,end)</tt> and return
+   * the number of cells that needed point evaluation.
+   */
+  unsigned int limit_cells (const unsigned int  begin,
+                            const unsigned int  end,
+                            Vector<double>     &solution) const;
+
+  /**
+   * The DoFHandler the solution vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,PositivityLimiter<dim,spacedim> > dof_handler;
+
+  /**
+   * The FE_DGT element of the limited component.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,PositivityLimiter<dim,spacedim> > fe;
+
+  /**
+   * The points at which positivity is enforced.
+   */
+  const Quadrature<dim> quadrature;
+
+  /**
+   * The lower bound $\varepsilon$.
+   */
+  const double epsilon;
+
+  /**
+   * The index within the cell of the degree of freedom of each shape
+   * function of #fe in the limited component.
+   */
+  std::vector<unsigned int> component_dofs;
+
+  /**
+   * The active cells and their degrees of freedom.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,277 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_dgt_ssp_runge_kutta.h>
+
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+LowStorageSSPRungeKutta<dim,spacedim>::
+LowStorageSSPRungeKutta (const DoFHandler<dim,spacedim> &dof_handler,
+                         const Method                    method)
+  :
+  dof_handler (&dof_handler, typeid(*this).name())
+{
+  const FiniteElement<dim,spacedim> &system_fe = dof_handler.get_fe();
+  fe = dynamic_cast<const FE_DGT<dim,spacedim>*>(&system_fe.base_element(0));
+  AssertThrow (fe != 0,
+               ExcMessage ("The Runge-Kutta driver requires FE_DGT elements."));
+  for (unsigned int b=1; b<system_fe.n_base_elements(); ++b)
+    AssertThrow (system_fe.base_element(b).get_name() == fe->get_name(),
+                 ExcMessage ("All base elements must be the same FE_DGT element."));
+
+  component_dofs.reinit (system_fe.n_components(), fe->dofs_per_cell);
+  for (unsigned int i=0; i<system_fe.dofs_per_cell; ++i)
+    component_dofs(system_fe.system_to_component_index(i).first,
+                   system_fe.system_to_component_index(i).second) = i;
+
+  switch (method)
+    {
+    case SSP_RK_2_2:
+      add_stage (1., 0., 1.);
+      add_stage (1., 1./2, 1./2);
+      break;
+
+    case SSP_RK_3_3:
+      add_stage (1., 0., 1.);
+      add_stage (1., 3./4, 1./4);
+      add_stage (1., 1./3, 2./3);
+      break;
+
+    case SSP_RK_5_2:
+      for (unsigned int s=0; s<4; ++s)
+        add_stage (1./4, 0., 1.);
+      add_stage (1./4, 1./5, 4./5);
+      break;
+
+    case SSP_RK_10_4:
+      // Ketcheson's algorithm with the registers q1, q2 reads
+      //   q1 = q1 + dt/6 F(q1)                   (five times)
+      //   q2 = q2/25 + 9/25 q1,  q1 = 15 q2 - 5 q1
+      //   q1 = q1 + dt/6 F(q1)                   (four times)
+      //   u  = q2 + 3/5 q1 + dt/10 F(q1)
+      // with q1 = q2 = u initially. the update of the registers is merged
+      // into the fifth stage
+      for (unsigned int s=0; s<4; ++s)
+        add_stage (1./6, 0., 1.);
+      add_stage (1./6, 3./5, 2./5, true, 1./25, 9./25);
+      for (unsigned int s=0; s<4; ++s)
+        add_stage (1./6, 0., 1.);
+      add_stage (1./6, 1., 3./5);
+      break;
+
+    default:
+      Assert (false, ExcNotImplemented());
+    }
+
+  // the first stage reads the solution vector, which also holds the
+  // register, from the neighbors
+  Assert (stages[0].update_register == false, ExcInternalError());
+
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+LowStorageSSPRungeKutta<dim,spacedim>::
+add_stage (const double c,
+           const double alpha,
+           const double beta,
+           const bool   update_register,
+           const double gamma,
+           const double delta)
+{
+  Stage stage;
+  stage.c = c;
+  stage.alpha = alpha;
+  stage.beta = beta;
+  stage.update_register = update_register;
+  stage.gamma = gamma;
+  stage.delta = delta;
+  stages.push_back (stage);
+}
+
+
+
+template <int dim, int spacedim>
+void
+LowStorageSSPRungeKutta<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+
+  inverse_mass_matrices.resize (connectivity.n_cells());
+  inverse_volume_scaling.resize (connectivity.n_cells());
+  for (unsigned int c=0; c<connectivity.n_cells(); ++c)
+    {
+      inverse_mass_matrices[c]
+        = &fe->get_scaled_inverse_mass_matrix (shape_classes, connectivity.cells[c]);
+      inverse_volume_scaling[c] = 1./std::pow (connectivity.cells[c]->diameter(), static_cast<int>(dim));
+    }
+
+  for (unsigned int v=0; v<2; ++v)
+    stage_vectors[v].reinit (dof_handler->n_dofs());
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+LowStorageSSPRungeKutta<dim,spacedim>::n_stages () const
+{
+  return stages.size();
+}
+
+
+
+template <int dim, int spacedim>
+void
+LowStorageSSPRungeKutta<dim,spacedim>::
+step (Vector<double>            &solution,
+      const double               time,
+      const double               time_step,
+      const ResidualFunction    &residual,
+      const CellLimiterFunction &cell_limiter,
+      const StageFunction       &stage_function)
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (stage_vectors[0].size(), dof_handler->n_dofs());
+
+  // the stage times follow from applying the method to u'=1. the register
+  // is a linear combination of u^n, with weight register_weight, and of
+  // the time increments
+  double stage_time = 0;
+  double register_weight = 1.;
+  double register_time = 0;
+
+  for (unsigned int s=0; s<stages.size(); ++s)
+    {
+      const Stage &stage = stages[s];
+      const Vector<double> &old_stage = (s == 0 ? solution : stage_vectors[(s-1)%2]);
+      Vector<double> &new_stage = (s+1 == stages.size() ? solution : stage_vectors[s%2]);
+
+      parallel::apply_to_subranges (0U, connectivity.n_cells(),
+                                    std_cxx11::bind (&LowStorageSSPRungeKutta<dim,spacedim>::compute_stage,
+                                                     this,
+                                                     std_cxx11::_1, std_cxx11::_2,
+                                                     std_cxx11::cref (stage),
+                                                     std_cxx11::cref (old_stage),
+                                                     std_cxx11::ref (new_stage),
+                                                     std_cxx11::ref (solution),
+                                                     time + stage_time * time_step,
+                                                     time_step,
+                                                     std_cxx11::cref (residual),
+                                                     std_cxx11::cref (cell_limiter)),
+                                    32);
+
+      if (stage_function)
+        stage_function (new_stage);
+
+      Assert (std::fabs (stage.alpha * register_weight + stage.beta - 1.) < 1e-12,
+              ExcInternalError());
+      const double increment_time = stage_time + stage.c;
+      stage_time = stage.alpha * register_time + stage.beta * increment_time;
+      if (stage.update_register)
+        {
+          register_weight = stage.gamma * register_weight + stage.delta;
+          register_time = stage.gamma * register_time + stage.delta * increment_time;
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+LowStorageSSPRungeKutta<dim,spacedim>::
+compute_stage (const unsigned int         begin,
+               const unsigned int         end,
+               const Stage               &stage,
+               const Vector<double>      &old_stage,
+               Vector<double>            &new_stage,
+               Vector<double>            &reg,
+               const double               time,
+               const double               time_step,
+               const ResidualFunction    &residual,
+               const CellLimiterFunction &cell_limiter) const
+{
+  const unsigned int dofs_per_cell = connectivity.dof_indices.size(1);
+  const unsigned int n_components = component_dofs.size(0);
+  Vector<double> cell_residual (dofs_per_cell);
+  Vector<double> values (dofs_per_cell);
+  Vector<double> component_src (fe->dofs_per_cell);
+  Vector<double> component_dst (fe->dofs_per_cell);
+
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      cell_residual = 0;
+      residual (c, old_stage, time, cell_residual);
+
+      // Y = S_old + c dt M^{-1} r, component by component
+      const FullMatrix<double> &inverse_mass_matrix = *inverse_mass_matrices[c];
+      const double factor = stage.c * time_step * inverse_volume_scaling[c];
+      for (unsigned int comp=0; comp<n_components; ++comp)
+        {
+          for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+            component_src(i) = cell_residual(component_dofs(comp,i));
+          inverse_mass_matrix.vmult (component_dst, component_src);
+          for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+            {
+              const unsigned int k = component_dofs(comp,i);
+              values(k) = old_stage(connectivity.dof_indices(c,k)) +
+                          factor * component_dst(i);
+            }
+        }
+
+      // the register is only read and written on this cell. if the new
+      // stage is the solution vector, the register is read before it is
+      // overwritten
+      for (unsigned int k=0; k<dofs_per_cell; ++k)
+        {
+          const types::global_dof_index index = connectivity.dof_indices(c,k);
+          const double y = values(k);
+          const double r = reg(index);
+          values(k) = stage.alpha * r + stage.beta * y;
+          if (stage.update_register)
+            reg(index) = stage.gamma * r + stage.delta * y;
+        }
+
+      if (cell_limiter)
+        cell_limiter (c, values);
+
+      for (unsigned int k=0; k<dofs_per_cell; ++k)
+        new_stage(connectivity.dof_indices(c,k)) = values(k);
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_ssp_runge_kutta.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,241 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_ssp_runge_kutta_h
+#define dealii__fe_dgt_ssp_runge_kutta_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A driver for low-storage strong stability preserving Runge-Kutta methods
+ * for discontinuous Galerkin discretizations with the FE_DGT element.
+ *
+ * Each stage is a single parallel pass over the active cells that, for
+ * each cell,
+ * <ol>
+ * <li> evaluates the residual of the cell from the previous stage by a
+ *      user supplied function,
+ * <li> applies the inverse of the mass matrix of the cell, see
+ *      FE_DGT::get_scaled_inverse_mass_matrix(), a reference to which is
+ *      stored for each cell by reinit() together with the factor $h^{-d}$,
+ * <li> forms the new stage value $S_{\text{new}} = \alpha R + \beta
+ *      (S_{\text{old}} + c\,\Delta t\, M^{-1} r(S_{\text{old}}))$ and, for
+ *      some methods, updates the register $R$,
+ * <li> applies an optional cell-local limiter, like the scaling of the
+ *      positivity preserving limiter,
+ * </ol>
+ * and writes only the coefficients of the cell. No global residual vector
+ * is formed. The residual of a cell may read the previous stage on the
+ * neighbors, so the new stage is written to a second vector and the two
+ * are swapped between stages. The register $R$ holds the solution at the
+ * beginning of the time step and is only accessed cell by cell, so it is
+ * stored in the solution vector itself, which is overwritten by the last
+ * stage. Altogether, two vectors are stored in addition to the solution.
+ * Limiters that need the neighbors, like WENOLimiter, can be called after
+ * each stage on the whole stage vector.
+ *
+ * The methods are written in the above form, whose coefficients are given
+ * in the documentation of #Method. The DoFHandler may use an FE_DGT
+ * element or an FESystem of FE_DGT elements, in which case the inverse
+ * mass matrix is applied to each component.
+ */
+template <int dim, int spacedim=dim>
+class LowStorageSSPRungeKutta : public Subscriptor
+{
+public:
+  /**
+   * The available methods.
+   */
+  enum Method
+  {
+    /**
+     * The optimal second order method with two stages and SSP coefficient
+     * one (Heun's method).
+     */
+    SSP_RK_2_2,
+    /**
+     * The optimal third order method with three stages and SSP coefficient
+     * one of Shu and Osher.
+     */
+    SSP_RK_3_3,
+    /**
+     * The second order method with five stages and SSP coefficient four of
+     * Ketcheson, i.e., effective SSP coefficient 0.8.
+     */
+    SSP_RK_5_2,
+    /**
+     * The fourth order method with ten stages and SSP coefficient six of
+     * Ketcheson, which updates the register once, after the fifth stage.
+     */
+    SSP_RK_10_4
+  };
+
+  /**
+   * The function that computes the residual of the cell with the given
+   * active_cell_index() from the stage vector at the given time. The
+   * residual is the right hand side of the discrete equations of the cell
+   * before multiplication by the inverse mass matrix, with one entry per
+   * degree of freedom of the cell.
+   */
+  typedef std_cxx11::function<void (const unsigned int, const Vector<double> &,
+                                    const double, Vector<double> &)> ResidualFunction;
+
+  /**
+   * A limiter applied to the coefficients of the cell with the given
+   * active_cell_index() as soon as its new stage value is known.
+   */
+  typedef std_cxx11::function<void (const unsigned int, Vector<double> &)> CellLimiterFunction;
+
+  /**
+   * A function applied to the whole stage vector after each stage.
+   */
+  typedef std_cxx11::function<void (Vector<double> &)> StageFunction;
+
+  /**
+   * Constructor. Calls reinit().
+   */
+  LowStorageSSPRungeKutta (const DoFHandler<dim,spacedim> &dof_handler,
+                           const Method                    method = SSP_RK_3_3);
+
+  /**
+   * Collect the indices of degrees of freedom of all active cells and
+   * allocate the stage vectors. Must be called again whenever the mesh or
+   * the numbering of degrees of freedom changes.
+   */
+  void reinit ();
+
+  /**
+   * Return the number of stages of the method.
+   */
+  unsigned int n_stages () const;
+
+  /**
+   * Advance @p solution from @p time by @p time_step. The optional
+   * @p cell_limiter and @p stage_function are applied to the result of
+   * each stage, including the last one.
+   */
+  void step (Vector<double>            &solution,
+             const double               time,
+             const double               time_step,
+             const ResidualFunction    &residual,
+             const CellLimiterFunction &cell_limiter   = CellLimiterFunction(),
+             const StageFunction       &stage_function = StageFunction());
+
+private:
+  /**
+   * The coefficients of one stage, see the documentation of this class:
+   * $Y = S_{\text{old}} + c\,\Delta t\,M^{-1}r(S_{\text{old}})$,
+   * $S_{\text{new}} = \alpha R + \beta Y$ and, if #update_register is set,
+   * $R := \gamma R + \delta Y$.
+   */
+  struct Stage
+  {
+    double c;
+    double alpha;
+    double beta;
+    bool   update_register;
+    double gamma;
+    double delta;
+  };
+
+  /**
+   * Append a stage with the given coefficients to #stages.
+   */
+  void add_stage (const double c,
+                  const double alpha,
+                  const double beta,
+                  const bool   update_register = false,
+                  const double gamma = 0.,
+                  const double delta = 0.);
+
+  /**
+   * Compute stage @p stage on the cells <tt>[begin,end)</tt>.
+   */
+  void compute_stage (const unsigned int         begin,
+                      const unsigned int         end,
+                      const Stage               &stage,
+                      const Vector<double>      &old_stage,
+                      Vector<double>            &new_stage,
+                      Vector<double>            &reg,
+                      const double               time,
+                      const double               time_step,
+                      const ResidualFunction    &residual,
+                      const CellLimiterFunction &cell_limiter) const;
+
+  /**
+   * The DoFHandler the solution lives on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,LowStorageSSPRungeKutta<dim,spacedim> > dof_handler;
+
+  /**
+   * The FE_DGT base element.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,LowStorageSSPRungeKutta<dim,spacedim> > fe;
+
+  /**
+   * The stages of the method.
+   */
+  std::vector<Stage> stages;
+
+  /**
+   * The index within the cell of the degree of freedom of shape function
+   * @p i of component @p c, i.e., <tt>component_dofs(c,i)</tt>.
+   */
+  Table<2,unsigned int> component_dofs;
+
+  /**
+   * The active cells and their degrees of freedom.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+
+  /**
+   * The inverse mass matrix of each active cell multiplied by $h^d$, which
+   * is shared by all cells of a shape class, and the factor $h^{-d}$.
+   */
+  std::vector<const FullMatrix<double> *> inverse_mass_matrices;
+  std::vector<double>                     inverse_volume_scaling;
+
+  /**
+   * The two stage vectors.
+   */
+  Vector<double> stage_vectors[2];
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
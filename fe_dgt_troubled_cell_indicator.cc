@@ -0,0 +1,262 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/fe/fe_dgt_troubled_cell_indicator.h>
+
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+TroubledCellIndicator<dim,spacedim>::AdditionalData::
+AdditionalData (const double threshold,
+                const double epsilon)
+  :
+  threshold (threshold),
+  epsilon (epsilon)
+{}
+
+
+
+template <int dim, int spacedim>
+TroubledCellIndicator<dim,spacedim>::
+TroubledCellIndicator (const DoFHandler<dim,spacedim> &dof_handler,
+                       const AdditionalData           &additional_data)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  fe (dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe()),
+      typeid(*this).name()),
+  additional_data (additional_data)
+{
+  AssertThrow (fe != 0,
+               ExcMessage ("The troubled cell indicator requires an FE_DGT element."));
+  reinit (QGauss<dim-1> (fe->degree+1));
+}
+
+
+
+template <int dim, int spacedim>
+void
+TroubledCellIndicator<dim,spacedim>::reinit (const Quadrature<dim-1> &face_quadrature)
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+  this->face_quadrature = face_quadrature;
+
+  cell_scaling.resize (connectivity.n_cells());
+  for (unsigned int c=0; c<connectivity.n_cells(); ++c)
+    cell_scaling[c] = std::pow (connectivity.cells[c]->diameter(), 0.5*(fe->degree+1));
+}
+
+
+
+template <int dim, int spacedim>
+void
+TroubledCellIndicator<dim,spacedim>::
+compute (const Vector<double>      &solution,
+         const VelocityFunction    &velocity,
+         std::vector<unsigned int> &troubled_cells,
+         Vector<double>            *indicators) const
+{
+  Assert (velocity, ExcMessage ("The velocity function must not be empty."));
+  do_compute (solution, velocity, troubled_cells, indicators);
+}
+
+
+
+template <int dim, int spacedim>
+void
+TroubledCellIndicator<dim,spacedim>::
+compute (const Vector<double>      &solution,
+         std::vector<unsigned int> &troubled_cells,
+         Vector<double>            *indicators) const
+{
+  do_compute (solution, VelocityFunction(), troubled_cells, indicators);
+}
+
+
+
+template <int dim, int spacedim>
+void
+TroubledCellIndicator<dim,spacedim>::
+do_compute (const Vector<double>      &solution,
+            const VelocityFunction    &velocity,
+            std::vector<unsigned int> &troubled_cells,
+            Vector<double>            *indicators) const
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  const unsigned int n_cells = connectivity.n_cells();
+  std::vector<double> cell_indicators (n_cells);
+  parallel::apply_to_subranges (0U, n_cells,
+                                std_cxx11::bind (&TroubledCellIndicator<dim,spacedim>::compute_cells,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (solution),
+                                                 std_cxx11::cref (velocity),
+                                                 std_cxx11::ref (cell_indicators)),
+                                64);
+
+  troubled_cells.clear ();
+  if (indicators != 0)
+    indicators->reinit (n_cells);
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      if (indicators != 0)
+        (*indicators)(c) = cell_indicators[c];
+      if (cell_indicators[c] > additional_data.threshold)
+        troubled_cells.push_back (c);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+TroubledCellIndicator<dim,spacedim>::
+compute_cells (const unsigned int      begin,
+               const unsigned int      end,
+               const Vector<double>   &solution,
+               const VelocityFunction &velocity,
+               std::vector<double>    &cell_indicators) const
+{
+  // only the geometry of the faces is needed, the solution is evaluated
+  // through its traces
+  const UpdateFlags flags = update_quadrature_points | update_normal_vectors | update_JxW_values;
+  FEFaceValues<dim,spacedim> fe_face_values (StaticMappingQ1<dim,spacedim>::mapping,
+                                             *fe, face_quadrature, flags);
+  FESubfaceValues<dim,spacedim> fe_subface_values (StaticMappingQ1<dim,spacedim>::mapping,
+                                                   *fe, face_quadrature, flags);
+
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  Vector<double> cell_coefficients (dofs_per_cell);
+  Vector<double> neighbor_coefficients (dofs_per_cell);
+  Vector<double> cell_trace (fe->n_face_trace_coefficients());
+  Vector<double> neighbor_trace (fe->n_face_trace_coefficients());
+  std::vector<double> cell_values (face_quadrature.size());
+  std::vector<double> neighbor_values (face_quadrature.size());
+
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+        = connectivity.cells[c];
+      connectivity.get_coefficients (solution, c, cell_coefficients);
+
+      // the jump integral and the measure of the inflow boundary of this
+      // cell. every face is visited from both sides, so that each cell only
+      // writes its own result
+      double jump_integral = 0;
+      double inflow_measure = 0;
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          if (cell->at_boundary(f))
+            continue;
+
+          fe->face_trace (shape_classes, cell, f, cell_coefficients, cell_trace);
+          const typename DoFHandler<dim,spacedim>::cell_iterator neighbor = cell->neighbor(f);
+          const unsigned int n_parts = (dim > 1 && neighbor->has_children() ?
+                                        cell->face(f)->n_children() : 1);
+          for (unsigned int part=0; part<n_parts; ++part)
+            {
+              // the part of the face shared with one neighbor, and the face
+              // of the neighbor it lies on
+              const FEFaceValuesBase<dim,spacedim> *face_values;
+              typename DoFHandler<dim,spacedim>::cell_iterator neighbor_cell = neighbor;
+              unsigned int neighbor_face;
+              if (dim == 1)
+                {
+                  // faces are points, adjacent to a single active neighbor
+                  fe_face_values.reinit (cell, f);
+                  face_values = &fe_face_values;
+                  while (neighbor_cell->has_children())
+                    neighbor_cell = neighbor_cell->child (1-f);
+                  neighbor_face = 1-f;
+                }
+              else if (neighbor->has_children())
+                {
+                  fe_subface_values.reinit (cell, f, part);
+                  face_values = &fe_subface_values;
+                  neighbor_cell = cell->neighbor_child_on_subface (f, part);
+                  neighbor_face = cell->neighbor_of_neighbor (f);
+                }
+              else
+                {
+                  fe_face_values.reinit (cell, f);
+                  face_values = &fe_face_values;
+                  neighbor_face = (cell->neighbor_is_coarser(f) ?
+                                   cell->neighbor_of_coarser_neighbor(f).first :
+                                   cell->neighbor_of_neighbor(f));
+                }
+
+              connectivity.get_coefficients (solution, neighbor_cell->active_cell_index(),
+                                             neighbor_coefficients);
+              fe->face_trace (shape_classes, neighbor_cell, neighbor_face,
+                              neighbor_coefficients, neighbor_trace);
+
+              const std::vector<Point<spacedim> > &points = face_values->get_quadrature_points();
+              fe->evaluate_face_trace (shape_classes, cell, f, cell_trace, points, cell_values);
+              fe->evaluate_face_trace (shape_classes, neighbor_cell, neighbor_face,
+                                       neighbor_trace, points, neighbor_values);
+
+              for (unsigned int q=0; q<points.size(); ++q)
+                {
+                  const double jump = cell_values[q] - neighbor_values[q];
+                  const double JxW = face_values->JxW(q);
+                  if (!velocity)
+                    {
+                      jump_integral += JxW * std::fabs (jump);
+                      inflow_measure += JxW;
+                    }
+                  else if (velocity (points[q]) * face_values->normal_vector(q) < 0)
+                    {
+                      jump_integral += JxW * jump;
+                      inflow_measure += JxW;
+                    }
+                }
+            }
+        }
+
+      if (inflow_measure == 0)
+        {
+          cell_indicators[c] = 0;
+          continue;
+        }
+
+      const double average
+        = std::max (std::fabs (fe->cell_average (shape_classes, cell, cell_coefficients)),
+                    additional_data.epsilon);
+      cell_indicators[c] = std::fabs (jump_integral) /
+                           (cell_scaling[c] * inflow_measure * average);
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_troubled_cell_indicator.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
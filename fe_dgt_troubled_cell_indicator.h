@@ -0,0 +1,194 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_troubled_cell_indicator_h
+#define dealii__fe_dgt_troubled_cell_indicator_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * Detection of troubled cells, i.e., cells on which a discontinuous Galerkin
+ * solution represented by the FE_DGT element needs to be limited.
+ *
+ * Two indicators are available. The KXRCF indicator of Krivodonova et al.
+ * flags a cell $K$ if
+ * @f[
+ *   \frac{\left|\int_{\partial K^-} (u_K - u_{K'}) \, ds\right|}
+ *        {h^{(k+1)/2} \, |\partial K^-| \, |\bar u_K|} > \theta,
+ * @f]
+ * where $\partial K^-$ is the inflow part of the boundary of $K$ with
+ * respect to a given velocity field, $u_{K'}$ is the trace of the solution
+ * from the neighbor, $\bar u_K$ is the mean value on $K$ and $\theta$ is
+ * AdditionalData::threshold. If no velocity is given, the whole boundary is
+ * used and the signed jump is replaced by its absolute value, which makes
+ * the indicator a plain jump indicator.
+ *
+ * The solution is evaluated on the faces through its trace polynomials,
+ * see FE_DGT::face_trace(), which only requires the face monomials at the
+ * quadrature points rather than all shape functions. reinit() therefore
+ * only collects the connectivity of the mesh and one scaling factor per
+ * cell. compute() processes the cells in parallel, each cell integrating
+ * the jumps over its own faces, or over the subfaces shared with the
+ * neighbors where the neighbor is refined. Boundary faces do not
+ * contribute. Since the traces are only available on flat faces, all faces
+ * of the mesh must be flat. The velocity function is called concurrently
+ * from several threads.
+ *
+ * reinit() has to be called again whenever the mesh or the numbering of
+ * degrees of freedom changes.
+ */
+template <int dim, int spacedim=dim>
+class TroubledCellIndicator : public Subscriptor
+{
+public:
+  /**
+   * Parameters of the indicator.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const double threshold = 1.,
+                    const double epsilon   = 1e-12);
+
+    /**
+     * Cells whose indicator exceeds this value are flagged.
+     */
+    double threshold;
+
+    /**
+     * Lower bound for the mean value used for the normalization, preventing
+     * division by zero.
+     */
+    double epsilon;
+  };
+
+  /**
+   * Type of the velocity field that determines the inflow boundaries.
+   */
+  typedef std_cxx11::function<Tensor<1,spacedim> (const Point<spacedim> &)> VelocityFunction;
+
+  /**
+   * Constructor. Calls reinit() with a face quadrature formula that
+   * integrates the traces of the solution exactly.
+   */
+  TroubledCellIndicator (const DoFHandler<dim,spacedim> &dof_handler,
+                         const AdditionalData           &additional_data = AdditionalData());
+
+  /**
+   * Collect the connectivity of the mesh and use @p face_quadrature for
+   * the integrals over the faces.
+   */
+  void reinit (const Quadrature<dim-1> &face_quadrature);
+
+  /**
+   * Compute the KXRCF indicator of all active cells with respect to the
+   * velocity field @p velocity, and return the active_cell_index() of the
+   * flagged cells in ascending order in @p troubled_cells. If
+   * @p indicators is not the null pointer, the value of the indicator of
+   * each active cell is written into it.
+   */
+  void compute (const Vector<double>      &solution,
+                const VelocityFunction    &velocity,
+                std::vector<unsigned int> &troubled_cells,
+                Vector<double>            *indicators = 0) const;
+
+  /**
+   * Same as above, but using the absolute value of the jumps over all
+   * faces of each cell.
+   */
+  void compute (const Vector<double>      &solution,
+                std::vector<unsigned int> &troubled_cells,
+                Vector<double>            *indicators = 0) const;
+
+private:
+  /**
+   * Common implementation of the two compute() functions. An empty
+   * @p velocity selects the jump indicator.
+   */
+  void do_compute (const Vector<double>      &solution,
+                   const VelocityFunction    &velocity,
+                   std::vector<unsigned int> &troubled_cells,
+                   Vector<double>            *indicators) const;
+
+  /**
+   * Compute the indicator of the cells with active_cell_index() in the
+   * range <tt>[begin,end)</tt> and write it into @p cell_indicators.
+   */
+  void compute_cells (const unsigned int      begin,
+                      const unsigned int      end,
+                      const Vector<double>   &solution,
+                      const VelocityFunction &velocity,
+                      std::vector<double>    &cell_indicators) const;
+
+  /**
+   * The DoFHandler the solution vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,TroubledCellIndicator<dim,spacedim> > dof_handler;
+
+  /**
+   * The finite element of #dof_handler.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,TroubledCellIndicator<dim,spacedim> > fe;
+
+  /**
+   * Parameters of the indicator.
+   */
+  const AdditionalData additional_data;
+
+  /**
+   * The active cells with their degrees of freedom and face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+
+  /**
+   * The scaling $h^{(k+1)/2}$ of each active cell.
+   */
+  std::vector<double> cell_scaling;
+
+  /**
+   * The quadrature formula on the faces.
+   */
+  Quadrature<dim-1> face_quadrature;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
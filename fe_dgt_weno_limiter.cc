@@ -0,0 +1,192 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/fe/fe_dgt_weno_limiter.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+WENOLimiter<dim,spacedim>::AdditionalData::
+AdditionalData (const double central_weight,
+                const double epsilon)
+  :
+  central_weight (central_weight),
+  epsilon (epsilon)
+{}
+
+
+
+template <int dim, int spacedim>
+WENOLimiter<dim,spacedim>::
+WENOLimiter (const DoFHandler<dim,spacedim> &dof_handler,
+             const AdditionalData           &additional_data)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  fe (dynamic_cast<const FE_DGT<dim,spacedim>*>(&dof_handler.get_fe()),
+      typeid(*this).name()),
+  additional_data (additional_data)
+{
+  AssertThrow (fe != 0,
+               ExcMessage ("The WENO limiter requires an FE_DGT element."));
+  Assert (additional_data.central_weight > 0 && additional_data.central_weight < 1,
+          ExcMessage ("The central weight must lie between zero and one."));
+  reinit ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+WENOLimiter<dim,spacedim>::reinit ()
+{
+  connectivity.reinit (*dof_handler);
+  shape_classes.reinit (*fe, dof_handler->get_triangulation());
+}
+
+
+
+template <int dim, int spacedim>
+void
+WENOLimiter<dim,spacedim>::
+limit (Vector<double>                  &solution,
+       const std::vector<unsigned int> &troubled_cells) const
+{
+  AssertDimension (solution.size(), dof_handler->n_dofs());
+  AssertDimension (connectivity.n_cells(), dof_handler->get_triangulation().n_active_cells());
+
+  // compute all reconstructions before writing any of them back, since
+  // troubled cells may be part of each other's stencils
+  Table<2,double> new_coefficients (troubled_cells.size(), fe->dofs_per_cell);
+  parallel::apply_to_subranges (0U, static_cast<unsigned int>(troubled_cells.size()),
+                                std_cxx11::bind (&WENOLimiter<dim,spacedim>::reconstruct,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::cref (solution),
+                                                 std_cxx11::cref (troubled_cells),
+                                                 std_cxx11::ref (new_coefficients)),
+                                16);
+
+  for (unsigned int t=0; t<troubled_cells.size(); ++t)
+    for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+      solution(connectivity.dof_indices(troubled_cells[t],i)) = new_coefficients(t,i);
+}
+
+
+
+template <int dim, int spacedim>
+void
+WENOLimiter<dim,spacedim>::
+limit (Vector<double>          &solution,
+       const std::vector<bool> &troubled_cell_flags) const
+{
+  AssertDimension (troubled_cell_flags.size(), connectivity.n_cells());
+
+  std::vector<unsigned int> troubled_cells;
+  for (unsigned int c=0; c<troubled_cell_flags.size(); ++c)
+    if (troubled_cell_flags[c])
+      troubled_cells.push_back (c);
+
+  limit (solution, troubled_cells);
+}
+
+
+
+template <int dim, int spacedim>
+void
+WENOLimiter<dim,spacedim>::
+reconstruct (const unsigned int               begin,
+             const unsigned int               end,
+             const Vector<double>            &solution,
+             const std::vector<unsigned int> &troubled_cells,
+             Table<2,double>                 &new_coefficients) const
+{
+  const unsigned int dofs_per_cell = fe->dofs_per_cell;
+  const double epsilon = additional_data.epsilon;
+
+  Vector<double> coefficients (dofs_per_cell);
+  Vector<double> neighbor_coefficients (dofs_per_cell);
+  Vector<double> candidate (dofs_per_cell);
+  Vector<double> result (dofs_per_cell);
+  FullMatrix<double> reexpansion;
+
+  for (unsigned int t=begin; t<end; ++t)
+    {
+      const unsigned int index = troubled_cells[t];
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell
+        = connectivity.cells[index];
+      connectivity.get_coefficients (solution, index, coefficients);
+
+      const unsigned int n_neighbors = connectivity.neighbor_start[index+1] -
+                                       connectivity.neighbor_start[index];
+      if (n_neighbors == 0)
+        {
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            new_coefficients(t,i) = coefficients(i);
+          continue;
+        }
+
+      const FullMatrix<double> &smoothness_matrix = fe->get_smoothness_matrix (shape_classes, cell);
+      const double average = fe->cell_average (shape_classes, cell, coefficients);
+      const double neighbor_weight = (1.-additional_data.central_weight) / n_neighbors;
+
+      // the polynomial on the cell itself
+      double beta = smoothness_matrix.matrix_norm_square (coefficients);
+      double weight = additional_data.central_weight / ((epsilon+beta)*(epsilon+beta));
+      double weight_sum = weight;
+      result.equ (weight, coefficients);
+
+      // the polynomials of the neighbors, extended to the cell and shifted
+      // to the mean value of the cell. the constant shape function has
+      // mean value one, so the shift only affects the first coefficient
+      for (unsigned int n=connectivity.neighbor_start[index];
+           n<connectivity.neighbor_start[index+1]; ++n)
+        {
+          const unsigned int neighbor_index = connectivity.neighbors[n];
+          const typename DoFHandler<dim,spacedim>::active_cell_iterator &neighbor
+            = connectivity.cells[neighbor_index];
+          connectivity.get_coefficients (solution, neighbor_index, neighbor_coefficients);
+
+          fe->get_reexpansion_matrix (neighbor->center(), neighbor->diameter(),
+                                      cell->center(), cell->diameter(),
+                                      reexpansion);
+          reexpansion.vmult (candidate, neighbor_coefficients);
+          candidate(0) += average - fe->cell_average (shape_classes, cell, candidate);
+
+          beta = smoothness_matrix.matrix_norm_square (candidate);
+          weight = neighbor_weight / ((epsilon+beta)*(epsilon+beta));
+          weight_sum += weight;
+          result.add (weight, candidate);
+        }
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        new_coefficients(t,i) = result(i) / weight_sum;
+    }
+}
+
+
+
+// explicit instantiations
+#include "fe_dgt_weno_limiter.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,166 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_dgt_weno_limiter_h
+#define dealii__fe_dgt_weno_limiter_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/table.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgt.h>
+#include <deal.II/fe/fe_dgt_cell_connectivity.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup fe */
+/*@{*/
+
+/**
+ * A WENO limiter for discontinuous Galerkin solutions represented by the
+ * FE_DGT element.
+ *
+ * On each troubled cell $K_0$, the polynomial $p_0$ of the solution is
+ * replaced by a convex combination of $p_0$ and the polynomials $p_l$ of
+ * the face neighbors $K_l$, extended to $K_0$ and shifted to have the same
+ * mean value on $K_0$ as $p_0$:
+ * @f[
+ *   \tilde p_l = p_l - \bar p_l + \bar p_0, \qquad
+ *   p_0^{\text{new}} = \sum_l \omega_l \tilde p_l, \qquad
+ *   \omega_l \propto \frac{\gamma_l}{(\varepsilon+\beta_l)^2}.
+ * @f]
+ * Here, $\beta_l$ is the smoothness indicator of $\tilde p_l$ on $K_0$ and
+ * $\gamma_l$ are the linear weights, with $\gamma_0$ given by
+ * AdditionalData::central_weight and the remainder split evenly between the
+ * neighbors. The limiter hence conserves the mean value on each cell.
+ *
+ * All operations act on the coefficients directly: the neighbor polynomials
+ * are extended by FE_DGT::get_reexpansion_matrix(), the mean values are
+ * computed by FE_DGT::cell_average() and the smoothness indicators are the
+ * cached quadratic forms of FE_DGT::get_smoothness_matrix(). Consequently,
+ * no FEValues object and no quadrature is involved.
+ *
+ * The face neighbors of all cells are collected into a connectivity table
+ * by reinit(), which must be called again whenever the mesh or the
+ * numbering of degrees of freedom changes. The limiter only touches the
+ * cells that are flagged as troubled, and processes them in parallel.
+ *
+ * The DoFHandler must use an FE_DGT element. Systems of equations must be
+ * limited one component at a time.
+ */
+template <int dim, int spacedim=dim>
+class WENOLimiter : public Subscriptor
+{
+public:
+  /**
+   * Parameters of the limiter.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const double central_weight = 0.998,
+                    const double epsilon        = 1e-6);
+
+    /**
+     * Linear weight $\gamma_0$ of the polynomial on the troubled cell
+     * itself.
+     */
+    double central_weight;
+
+    /**
+     * The constant $\varepsilon$ in the nonlinear weights, preventing
+     * division by zero for smooth data.
+     */
+    double epsilon;
+  };
+
+  /**
+   * Constructor. Calls reinit().
+   */
+  WENOLimiter (const DoFHandler<dim,spacedim> &dof_handler,
+               const AdditionalData           &additional_data = AdditionalData());
+
+  /**
+   * Set up the connectivity table and the indices of degrees of freedom of
+   * all active cells.
+   */
+  void reinit ();
+
+  /**
+   * Limit the cells whose active_cell_index() is listed in
+   * @p troubled_cells. The reconstruction on each cell is computed from the
+   * values of @p solution before limiting, i.e., the result does not depend
+   * on the order of the list.
+   */
+  void limit (Vector<double>                  &solution,
+              const std::vector<unsigned int> &troubled_cells) const;
+
+  /**
+   * Same as above, but with the troubled cells given by a vector of flags
+   * indexed by active_cell_index().
+   */
+  void limit (Vector<double>          &solution,
+              const std::vector<bool> &troubled_cell_flags) const;
+
+private:
+  /**
+   * Compute the limited coefficients of the troubled cells with indices
+   * <tt>[begin,end)</tt> in @p troubled_cells into the corresponding rows
+   * of @p new_coefficients.
+   */
+  void reconstruct (const unsigned int               begin,
+                    const unsigned int               end,
+                    const Vector<double>            &solution,
+                    const std::vector<unsigned int> &troubled_cells,
+                    Table<2,double>                 &new_coefficients) const;
+
+  /**
+   * The DoFHandler the solution vectors live on.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,WENOLimiter<dim,spacedim> > dof_handler;
+
+  /**
+   * The finite element of #dof_handler.
+   */
+  SmartPointer<const FE_DGT<dim,spacedim>,WENOLimiter<dim,spacedim> > fe;
+
+  /**
+   * Parameters of the limiter.
+   */
+  const AdditionalData additional_data;
+
+  /**
+   * The active cells with their degrees of freedom and face neighbors.
+   */
+  internal::FE_DGTImplementation::CellConnectivity<dim,spacedim> connectivity;
+
+  /**
+   * The shape classes of the active cells, see FE_DGT::ShapeClassCache.
+   */
+  typename FE_DGT<dim,spacedim>::ShapeClassCache shape_classes;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
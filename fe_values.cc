@@ -57,6 +57,54 @@ namespace
   {
     return (is.is_element(cell_number) ? 1 : 0);
   }
+
+
+  // return a pointer to the element with index @p first_index if the
+  // vector stores its elements contiguously in memory, so that the
+  // @p n_elements entries starting there can be read directly. for all
+  // other vector types (block vectors, PETSc and Trilinos vectors, index
+  // sets) return a null pointer, which makes the caller fall back to
+  // gathering the entries element by element
+  template <class VectorType>
+  const typename VectorType::value_type *
+  get_vector_range (const VectorType &,
+                    const types::global_dof_index,
+                    const unsigned int)
+  {
+    return 0;
+  }
+
+
+  template <typename Number>
+  const Number *
+  get_vector_range (const Vector<Number> &vector,
+                    const types::global_dof_index first_index,
+                    const unsigned int n_elements)
+  {
+    Assert (first_index + n_elements <= vector.size(),
+            ExcIndexRange (first_index + n_elements, 0, vector.size()+1));
+    (void)n_elements;
+    return vector.begin() + first_index;
+  }
+
+
+  // same as above, but for a set of indices. the indices must form a
+  // contiguous, ascending range for a pointer to be returned
+  template <class VectorType>
+  const typename VectorType::value_type *
+  get_vector_range (const VectorType &vector,
+                    const VectorSlice<const std::vector<types::global_dof_index> > &indices)
+  {
+    if (indices.size() == 0)
+      return 0;
+
+    const types::global_dof_index first_index = indices[0];
+    for (unsigned int i=1; i<indices.size(); ++i)
+      if (indices[i] != first_index + i)
+        return 0;
+
+    return get_vector_range (vector, first_index, indices.size());
+  }
 }
 
 
@@ -452,10 +500,10 @@ namespace FEValuesViews
     // values/gradients/... at quadrature points
 
     // ------------------------- scalar functions --------------------------
-    template <int dim, int spacedim, typename Number>
+    template <int dim, int spacedim, typename Number, typename ShapeNumber>
     void
     do_function_values (const ::dealii::Vector<Number> &dof_values,
-                        const Table<2,double>          &shape_values,
+                        const Table<2,ShapeNumber>     &shape_values,
                         const std::vector<typename Scalar<dim,spacedim>::ShapeFunctionData> &shape_function_data,
                         std::vector<typename ProductType<Number,double>::type>            &values)
     {
@@ -474,7 +522,7 @@ namespace FEValuesViews
             if (value == Number() )
               continue;
 
-            const double *shape_value_ptr =
+            const ShapeNumber *shape_value_ptr =
               &shape_values(shape_function_data[shape_function].row_index, 0);
             for (unsigned int q_point=0; q_point<n_quadrature_points; ++q_point)
               values[q_point] += value **shape_value_ptr++;
@@ -518,6 +566,53 @@ namespace FEValuesViews
 
 
 
+    // same as above, but read the derivatives from the structure-of-arrays
+    // copy that FEValuesBase keeps if requested. accumulate one tensor
+    // component at a time in a contiguous array
+    template <int order, int dim, int spacedim, typename Number, typename ShapeNumber>
+    void
+    do_function_derivatives (const ::dealii::Vector<Number> &dof_values,
+                             const dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber> &shape_derivatives,
+                             const std::vector<typename Scalar<dim,spacedim>::ShapeFunctionData> &shape_function_data,
+                             std::vector<typename ProductType<Number,dealii::Tensor<order,spacedim> >::type> &derivatives)
+    {
+      typedef typename ProductType<Number,double>::type value_type;
+
+      const unsigned int dofs_per_cell = dof_values.size();
+      const unsigned int n_quadrature_points = dofs_per_cell > 0 ?
+                                               shape_derivatives.n_quadrature_points() : derivatives.size();
+      AssertDimension (derivatives.size(), n_quadrature_points);
+
+      std::fill (derivatives.begin(), derivatives.end(),
+                 typename ProductType<Number,dealii::Tensor<order,spacedim> >::type());
+
+      std::vector<value_type> component_values (n_quadrature_points);
+      for (unsigned int c=0;
+           c<dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber>::n_components; ++c)
+        {
+          std::fill (component_values.begin(), component_values.end(), value_type());
+          for (unsigned int shape_function=0;
+               shape_function<dofs_per_cell; ++shape_function)
+            if (shape_function_data[shape_function].is_nonzero_shape_function_component)
+              {
+                const Number value = dof_values(shape_function);
+                if (value == Number() )
+                  continue;
+
+                const ShapeNumber *shape_derivative_ptr =
+                  shape_derivatives.component (c, shape_function_data[shape_function].row_index);
+                for (unsigned int q_point=0; q_point<n_quadrature_points; ++q_point)
+                  component_values[q_point] += value * shape_derivative_ptr[q_point];
+              }
+
+          for (unsigned int q_point=0; q_point<n_quadrature_points; ++q_point)
+            dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber>::
+            set_component (derivatives[q_point], c, component_values[q_point]);
+        }
+    }
+
+
+
     template <int dim, int spacedim, typename Number>
     void
     do_function_laplacians (const ::dealii::Vector<Number> &dof_values,
@@ -549,6 +644,46 @@ namespace FEValuesViews
 
 
 
+    // same as above, but read the Hessians from their compressed
+    // structure-of-arrays copy. the diagonal entries are the first spacedim
+    // stored components, so only those arrays need to be touched
+    template <int dim, int spacedim, typename Number, typename ShapeNumber>
+    void
+    do_function_laplacians (const ::dealii::Vector<Number> &dof_values,
+                            const dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,ShapeNumber> &shape_hessians,
+                            const std::vector<typename Scalar<dim,spacedim>::ShapeFunctionData> &shape_function_data,
+                            std::vector<typename ProductType<Number,double>::type>           &laplacians)
+    {
+      const unsigned int dofs_per_cell = dof_values.size();
+      const unsigned int n_quadrature_points = dofs_per_cell > 0 ?
+                                               shape_hessians.n_quadrature_points() : laplacians.size();
+      AssertDimension (laplacians.size(), n_quadrature_points);
+
+      std::fill (laplacians.begin(), laplacians.end(), typename ProductType<Number,double>::type());
+
+      for (unsigned int shape_function=0;
+           shape_function<dofs_per_cell; ++shape_function)
+        if (shape_function_data[shape_function].is_nonzero_shape_function_component)
+          {
+            const Number value = dof_values(shape_function);
+            if (value == Number())
+              continue;
+
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                Assert (shape_hessians.component_indices(d)[0] == d &&
+                        shape_hessians.component_indices(d)[1] == d,
+                        ExcInternalError());
+                const ShapeNumber *shape_hessian_ptr =
+                  shape_hessians.component (d, shape_function_data[shape_function].row_index);
+                for (unsigned int q_point=0; q_point<n_quadrature_points; ++q_point)
+                  laplacians[q_point] += value * shape_hessian_ptr[q_point];
+              }
+          }
+    }
+
+
+
     // ----------------------------- vector part ---------------------------
 
     template <int dim, int spacedim, typename Number>
@@ -1280,8 +1415,12 @@ namespace FEValuesViews
     // get function values of dofs on this cell and call internal worker function
     dealii::Vector<typename InputVector::value_type> dof_values(fe_values.dofs_per_cell);
     fe_values.present_cell->get_interpolated_dof_values(fe_function, dof_values);
-    internal::do_function_values<dim,spacedim>
-    (dof_values, fe_values.finite_element_output.shape_values, shape_function_data, values);
+    if (!fe_values.single_precision_shape_values.empty())
+      internal::do_function_values<dim,spacedim>
+      (dof_values, fe_values.single_precision_shape_values, shape_function_data, values);
+    else
+      internal::do_function_values<dim,spacedim>
+      (dof_values, fe_values.finite_element_output.shape_values, shape_function_data, values);
   }
 
 
@@ -1304,8 +1443,15 @@ namespace FEValuesViews
     // get function values of dofs on this cell
     dealii::Vector<typename InputVector::value_type> dof_values (fe_values.dofs_per_cell);
     fe_values.present_cell->get_interpolated_dof_values(fe_function, dof_values);
-    internal::do_function_derivatives<1,dim,spacedim>
-    (dof_values, fe_values.finite_element_output.shape_gradients, shape_function_data, gradients);
+    if (!fe_values.single_precision_shape_gradients.empty())
+      internal::do_function_derivatives<1,dim,spacedim>
+      (dof_values, fe_values.single_precision_shape_gradients, shape_function_data, gradients);
+    else if (!fe_values.shape_gradient_components.empty())
+      internal::do_function_derivatives<1,dim,spacedim>
+      (dof_values, fe_values.shape_gradient_components, shape_function_data, gradients);
+    else
+      internal::do_function_derivatives<1,dim,spacedim>
+      (dof_values, fe_values.finite_element_output.shape_gradients, shape_function_data, gradients);
   }
 
 
@@ -1328,8 +1474,15 @@ namespace FEValuesViews
     // get function values of dofs on this cell
     dealii::Vector<typename InputVector::value_type> dof_values (fe_values.dofs_per_cell);
     fe_values.present_cell->get_interpolated_dof_values(fe_function, dof_values);
-    internal::do_function_derivatives<2,dim,spacedim>
-    (dof_values, fe_values.finite_element_output.shape_hessians, shape_function_data, hessians);
+    if (!fe_values.single_precision_shape_hessians.empty())
+      internal::do_function_derivatives<2,dim,spacedim>
+      (dof_values, fe_values.single_precision_shape_hessians, shape_function_data, hessians);
+    else if (!fe_values.shape_hessian_components.empty())
+      internal::do_function_derivatives<2,dim,spacedim>
+      (dof_values, fe_values.shape_hessian_components, shape_function_data, hessians);
+    else
+      internal::do_function_derivatives<2,dim,spacedim>
+      (dof_values, fe_values.finite_element_output.shape_hessians, shape_function_data, hessians);
   }
 
 
@@ -1352,8 +1505,15 @@ namespace FEValuesViews
     // get function values of dofs on this cell
     dealii::Vector<typename InputVector::value_type> dof_values (fe_values.dofs_per_cell);
     fe_values.present_cell->get_interpolated_dof_values(fe_function, dof_values);
-    internal::do_function_laplacians<dim,spacedim>
-    (dof_values, fe_values.finite_element_output.shape_hessians, shape_function_data, laplacians);
+    if (!fe_values.single_precision_shape_hessians.empty())
+      internal::do_function_laplacians<dim,spacedim>
+      (dof_values, fe_values.single_precision_shape_hessians, shape_function_data, laplacians);
+    else if (!fe_values.shape_hessian_components.empty())
+      internal::do_function_laplacians<dim,spacedim>
+      (dof_values, fe_values.shape_hessian_components, shape_function_data, laplacians);
+    else
+      internal::do_function_laplacians<dim,spacedim>
+      (dof_values, fe_values.finite_element_output.shape_hessians, shape_function_data, laplacians);
   }
 
 
@@ -1807,6 +1967,21 @@ public:
   types::global_dof_index
   n_dofs_for_dof_handler () const = 0;
 
+  /**
+   * If the present cell is
+   * active and its degrees of
+   * freedom are numbered
+   * consecutively, i.e. local
+   * DoF <tt>i</tt> has global
+   * index <tt>first+i</tt>,
+   * return <tt>first</tt>.
+   * Otherwise return
+   * numbers::invalid_dof_index.
+   */
+  virtual
+  types::global_dof_index
+  first_contiguous_dof_index () const = 0;
+
 #include "fe_values.decl.1.inst"
 
   /// Call
@@ -1876,6 +2051,22 @@ public:
   types::global_dof_index
   n_dofs_for_dof_handler () const;
 
+  /**
+   * Return the first index of
+   * the consecutively numbered
+   * degrees of freedom of this
+   * cell, or
+   * numbers::invalid_dof_index
+   * if they are not
+   * consecutive. The answer is
+   * computed on first use and
+   * kept until the next
+   * reinit().
+   */
+  virtual
+  types::global_dof_index
+  first_contiguous_dof_index () const;
+
 #include "fe_values.decl.2.inst"
 
   /// Call
@@ -1893,6 +2084,20 @@ private:
    * we use in this object.
    */
   const CI cell;
+
+  /**
+   * Whether
+   * first_contiguous_dof_index()
+   * has already been computed
+   * for this cell.
+   */
+  mutable bool contiguity_checked;
+
+  /**
+   * Cached result of
+   * first_contiguous_dof_index().
+   */
+  mutable types::global_dof_index first_dof_index;
 };
 
 
@@ -1979,6 +2184,17 @@ public:
   types::global_dof_index
   n_dofs_for_dof_handler () const;
 
+  /**
+   * Implement the respective
+   * function of the base
+   * class. Since this is not
+   * possible, we just raise an
+   * error.
+   */
+  virtual
+  types::global_dof_index
+  first_contiguous_dof_index () const;
+
 #include "fe_values.decl.2.inst"
 
   /// Call
@@ -2019,7 +2235,9 @@ template <int dim, int spacedim>
 template <typename CI>
 FEValuesBase<dim,spacedim>::CellIterator<CI>::CellIterator (const CI &cell)
   :
-  cell(cell)
+  cell(cell),
+  contiguity_checked(false),
+  first_dof_index(numbers::invalid_dof_index)
 {}
 
 
@@ -2044,6 +2262,37 @@ FEValuesBase<dim,spacedim>::CellIterator<CI>::n_dofs_for_dof_handler () const
 
 
 
+template <int dim, int spacedim>
+template <typename CI>
+types::global_dof_index
+FEValuesBase<dim,spacedim>::CellIterator<CI>::first_contiguous_dof_index () const
+{
+  if (contiguity_checked)
+    return first_dof_index;
+
+  contiguity_checked = true;
+
+  // inactive cells have their values interpolated from their children,
+  // so there is no range of the global vector we could read directly
+  if (cell->has_children())
+    return first_dof_index;
+
+  const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+  if (dofs_per_cell == 0)
+    return first_dof_index;
+
+  std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+  cell->get_dof_indices (dof_indices);
+  for (unsigned int i=1; i<dofs_per_cell; ++i)
+    if (dof_indices[i] != dof_indices[0] + i)
+      return first_dof_index;
+
+  first_dof_index = dof_indices[0];
+  return first_dof_index;
+}
+
+
+
 #include "fe_values.impl.1.inst"
 
 
@@ -2105,6 +2354,16 @@ FEValuesBase<dim,spacedim>::TriaCellIterator::n_dofs_for_dof_handler () const
 }
 
 
+
+template <int dim, int spacedim>
+types::global_dof_index
+FEValuesBase<dim,spacedim>::TriaCellIterator::first_contiguous_dof_index () const
+{
+  Assert (false, ExcMessage (message_string));
+  return numbers::invalid_dof_index;
+}
+
+
 #include "fe_values.impl.2.inst"
 
 
@@ -2265,6 +2524,101 @@ namespace internal
               MemoryConsumption::memory_consumption (shape_3rd_derivatives) +
               MemoryConsumption::memory_consumption (shape_function_to_row_table));
     }
+
+
+
+
+    template <int order, int spacedim, typename Number>
+    ShapeDerivativeComponents<order,spacedim,Number>::ShapeDerivativeComponents ()
+      :
+      n_table_rows (0),
+      n_q_points (0),
+      row_length (0)
+    {}
+
+
+
+    template <int order, int spacedim, typename Number>
+    void
+    ShapeDerivativeComponents<order,spacedim,Number>::
+    reinit (const dealii::Table<2,dealii::Tensor<order,spacedim> > &shape_derivatives)
+    {
+      reinit (shape_derivatives.n_rows(), shape_derivatives.n_cols());
+
+      // transpose the table
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          const TableIndices<order> indices = component_indices (c);
+          for (unsigned int row=0; row<n_table_rows; ++row)
+            {
+              Number *component_ptr = component (c, row);
+              const dealii::Tensor<order,spacedim> *shape_derivative_ptr
+                = n_q_points > 0 ? &shape_derivatives[row][0] : 0;
+              for (unsigned int q=0; q<n_q_points; ++q)
+                component_ptr[q] = static_cast<Number>(shape_derivative_ptr[q][indices]);
+            }
+        }
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    void
+    ShapeDerivativeComponents<order,spacedim,Number>::
+    reinit (const unsigned int n_rows,
+            const unsigned int n_quadrature_points)
+    {
+      // the padding does not depend on the values, so there is nothing to
+      // do if the size is unchanged
+      if (n_rows == n_table_rows && n_quadrature_points == n_q_points)
+        return;
+
+      n_table_rows = n_rows;
+      n_q_points   = n_quadrature_points;
+
+      // pad each array to a multiple of 64 bytes, the alignment of the
+      // memory handed out by AlignedVector, so that every array starts at
+      // an aligned address
+      const unsigned int n_numbers_per_line = 64/sizeof(Number);
+      row_length = ((n_q_points + n_numbers_per_line - 1) / n_numbers_per_line) *
+                   n_numbers_per_line;
+
+      const std::size_t size = static_cast<std::size_t>(n_components) *
+                               n_table_rows * row_length;
+      data.resize_fast (size);
+
+      // the padding entries are set to zero so that vectorized loops
+      // running over the full row length add nothing
+      for (unsigned int c=0; c<n_components; ++c)
+        for (unsigned int row=0; row<n_table_rows; ++row)
+          {
+            Number *component_ptr = component (c, row);
+            for (unsigned int q=n_q_points; q<row_length; ++q)
+              component_ptr[q] = 0;
+          }
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    void
+    ShapeDerivativeComponents<order,spacedim,Number>::clear ()
+    {
+      n_table_rows = 0;
+      n_q_points   = 0;
+      row_length   = 0;
+      data.clear ();
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    std::size_t
+    ShapeDerivativeComponents<order,spacedim,Number>::memory_consumption () const
+    {
+      return (sizeof(*this) +
+              MemoryConsumption::memory_consumption (data));
+    }
   }
 }
 
@@ -2284,6 +2638,9 @@ FEValuesBase<dim,spacedim>::FEValuesBase (const unsigned int n_q_points,
   dofs_per_cell (dofs_per_cell),
   mapping(&mapping, typeid(*this).name()),
   fe(&fe, typeid(*this).name()),
+  shape_derivative_layout (array_of_structs),
+  released_shape_tables (update_default),
+  shape_table_precision (double_precision),
   fe_values_views_cache (*this)
 {
   Assert (n_q_points > 0,
@@ -2312,10 +2669,10 @@ namespace internal
   // compilation and reduces the size of the final file since all the
   // different global vectors get channeled through the same code.
 
-  template <typename Number, typename Number2>
+  template <typename Number, typename Number2, typename ShapeNumber>
   void
   do_function_values (const Number2         *dof_values_ptr,
-                      const dealii::Table<2,double> &shape_values,
+                      const dealii::Table<2,ShapeNumber> &shape_values,
                       std::vector<Number>   &values)
   {
     // scalar finite elements, so shape_values.size() == dofs_per_cell
@@ -2340,12 +2697,28 @@ namespace internal
         if (value == Number2())
           continue;
 
-        const double *shape_value_ptr = &shape_values(shape_func, 0);
+        const ShapeNumber *shape_value_ptr = &shape_values(shape_func, 0);
         for (unsigned int point=0; point<n_quadrature_points; ++point)
           values[point] += value **shape_value_ptr++;
       }
   }
 
+  // use the single precision copy of the shape values if FEValuesBase has
+  // filled one, otherwise the table filled by the finite element
+  template <typename Number, typename Number2>
+  inline
+  void
+  do_function_values (const Number2         *dof_values_ptr,
+                      const dealii::Table<2,double> &shape_values,
+                      const dealii::Table<2,float>  &single_precision_shape_values,
+                      std::vector<Number>   &values)
+  {
+    if (!single_precision_shape_values.empty())
+      do_function_values (dof_values_ptr, single_precision_shape_values, values);
+    else
+      do_function_values (dof_values_ptr, shape_values, values);
+  }
+
   template <int dim, int spacedim, typename VectorType, typename Number>
   void
   do_function_values (const Number                      *dof_values_ptr,
@@ -2479,6 +2852,73 @@ namespace internal
       }
   }
 
+
+
+  // same as above, but read the derivatives from their structure-of-arrays
+  // copy. for each tensor component, the contributions of all shape
+  // functions are accumulated in a contiguous array with unit-stride loops
+  // that the compiler can vectorize, and only then scattered into the
+  // output tensors
+  template <int order, int spacedim, typename Number, typename ShapeNumber>
+  void
+  do_function_derivatives (const Number                     *dof_values_ptr,
+                           const dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber> &shape_derivatives,
+                           std::vector<Tensor<order,spacedim,Number> > &derivatives)
+  {
+    const unsigned int dofs_per_cell = shape_derivatives.n_rows();
+    const unsigned int n_quadrature_points = dofs_per_cell > 0 ?
+                                             shape_derivatives.n_quadrature_points() : derivatives.size();
+    AssertDimension(derivatives.size(), n_quadrature_points);
+
+    std::fill_n (derivatives.begin(), n_quadrature_points, Tensor<order,spacedim,Number>());
+    if (dofs_per_cell == 0)
+      return;
+
+    std::vector<Number> component_values (n_quadrature_points);
+    for (unsigned int c=0;
+         c<dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber>::n_components; ++c)
+      {
+        std::fill (component_values.begin(), component_values.end(), Number());
+        for (unsigned int shape_func=0; shape_func<dofs_per_cell; ++shape_func)
+          {
+            const Number value = dof_values_ptr[shape_func];
+            if (value == Number())
+              continue;
+
+            const ShapeNumber *shape_derivative_ptr = shape_derivatives.component (c, shape_func);
+            for (unsigned int point=0; point<n_quadrature_points; ++point)
+              component_values[point] += value * shape_derivative_ptr[point];
+          }
+
+        for (unsigned int point=0; point<n_quadrature_points; ++point)
+          dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,ShapeNumber>::
+          set_component (derivatives[point], c, component_values[point]);
+      }
+  }
+
+
+
+  // dispatch to one of the two functions above, depending on which copies
+  // of the derivatives FEValuesBase has filled: single precision tables
+  // take precedence over the double precision structure-of-arrays copy,
+  // which in turn takes precedence over the table filled by the element
+  template <int order, int spacedim, typename Number>
+  inline
+  void
+  do_function_derivatives (const Number                     *dof_values_ptr,
+                           const dealii::Table<2,Tensor<order,spacedim> > &shape_derivatives,
+                           const dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim> &shape_derivative_components,
+                           const dealii::internal::FEValues::ShapeDerivativeComponents<order,spacedim,float> &single_precision_shape_derivatives,
+                           std::vector<Tensor<order,spacedim,Number> > &derivatives)
+  {
+    if (!single_precision_shape_derivatives.empty())
+      do_function_derivatives (dof_values_ptr, single_precision_shape_derivatives, derivatives);
+    else if (!shape_derivative_components.empty())
+      do_function_derivatives (dof_values_ptr, shape_derivative_components, derivatives);
+    else
+      do_function_derivatives (dof_values_ptr, shape_derivatives, derivatives);
+  }
+
   template <int order, int dim, int spacedim, typename Number>
   void
   do_function_derivatives (const Number                      *dof_values_ptr,
@@ -2605,6 +3045,61 @@ namespace internal
       }
   }
 
+
+  // same as above, but read the Hessians from their compressed
+  // structure-of-arrays copy. the diagonal entries are the first spacedim
+  // stored components, so only those arrays need to be touched
+  template <int spacedim, typename Number, typename Number2, typename ShapeNumber>
+  void
+  do_function_laplacians (const Number2        *dof_values_ptr,
+                          const dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,ShapeNumber> &shape_hessians,
+                          std::vector<Number> &laplacians)
+  {
+    const unsigned int dofs_per_cell = shape_hessians.n_rows();
+    const unsigned int n_quadrature_points = dofs_per_cell > 0 ?
+                                             shape_hessians.n_quadrature_points() : laplacians.size();
+    AssertDimension(laplacians.size(), n_quadrature_points);
+
+    // initialize with zero
+    std::fill_n (laplacians.begin(), n_quadrature_points, Number());
+
+    for (unsigned int shape_func=0; shape_func<dofs_per_cell; ++shape_func)
+      {
+        const Number2 value = dof_values_ptr[shape_func];
+        if (value == Number2())
+          continue;
+
+        for (unsigned int d=0; d<spacedim; ++d)
+          {
+            Assert (shape_hessians.component_indices(d)[0] == d &&
+                    shape_hessians.component_indices(d)[1] == d,
+                    ExcInternalError());
+            const ShapeNumber *shape_hessian_ptr = shape_hessians.component (d, shape_func);
+            for (unsigned int point=0; point<n_quadrature_points; ++point)
+              laplacians[point] += value * shape_hessian_ptr[point];
+          }
+      }
+  }
+
+  // dispatch to one of the two functions above, see the corresponding
+  // function for gradients and Hessians
+  template <int spacedim, typename Number, typename Number2>
+  inline
+  void
+  do_function_laplacians (const Number2        *dof_values_ptr,
+                          const dealii::Table<2,Tensor<2,spacedim> > &shape_hessians,
+                          const dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim> &shape_hessian_components,
+                          const dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,float> &single_precision_shape_hessians,
+                          std::vector<Number> &laplacians)
+  {
+    if (!single_precision_shape_hessians.empty())
+      do_function_laplacians (dof_values_ptr, single_precision_shape_hessians, laplacians);
+    else if (!shape_hessian_components.empty())
+      do_function_laplacians (dof_values_ptr, shape_hessian_components, laplacians);
+    else
+      do_function_laplacians (dof_values_ptr, shape_hessians, laplacians);
+  }
+
   template <int dim, int spacedim, typename VectorType, typename Number>
   void
   do_function_laplacians (const Number                    *dof_values_ptr,
@@ -2706,6 +3201,30 @@ namespace internal
 
 
 
+template <int dim, int spacedim>
+template <class InputVector>
+const typename InputVector::value_type *
+FEValuesBase<dim,spacedim>::get_present_cell_dof_values (
+  const InputVector                        &fe_function,
+  Vector<typename InputVector::value_type> &dof_values) const
+{
+  // if the present cell owns a consecutive range of DoF indices (as is the
+  // case for discontinuous elements numbered cell by cell) and the vector
+  // stores its elements contiguously, read the coefficients in place
+  const types::global_dof_index first_dof_index
+    = present_cell->first_contiguous_dof_index();
+  if (first_dof_index != numbers::invalid_dof_index)
+    if (const typename InputVector::value_type *dof_values_ptr
+        = get_vector_range (fe_function, first_dof_index, dofs_per_cell))
+      return dof_values_ptr;
+
+  dof_values.reinit (dofs_per_cell, true);
+  present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  return dof_values.begin();
+}
+
+
+
 template <int dim, int spacedim>
 template <class InputVector>
 void FEValuesBase<dim,spacedim>::get_function_values (
@@ -2722,10 +3241,10 @@ void FEValuesBase<dim,spacedim>::get_function_values (
                    present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_values (dof_values.begin(), this->finite_element_output.shape_values,
-                                values);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_values (dof_values_ptr, this->finite_element_output.shape_values,
+                                single_precision_shape_values, values);
 }
 
 
@@ -2744,12 +3263,17 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   AssertDimension (indices.size(), dofs_per_cell);
 
   // avoid allocation when the local size is small enough
-  if (dofs_per_cell <= 100)
+  // read the values in place if the indices form a consecutive range
+  if (const Number *dof_values_ptr = get_vector_range (fe_function, indices))
+    internal::do_function_values(dof_values_ptr, this->finite_element_output.shape_values,
+                                 single_precision_shape_values, values);
+  else if (dofs_per_cell <= 100)
     {
       Number dof_values[100];
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
-      internal::do_function_values(&dof_values[0], this->finite_element_output.shape_values, values);
+      internal::do_function_values(&dof_values[0], this->finite_element_output.shape_values,
+                                   single_precision_shape_values, values);
     }
   else
     {
@@ -2757,7 +3281,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_values(dof_values.begin(), this->finite_element_output.shape_values,
-                                   values);
+                                   single_precision_shape_values, values);
     }
 }
 
@@ -2775,13 +3299,15 @@ void FEValuesBase<dim,spacedim>::get_function_values (
 
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
+  AssertThrow (!(released_shape_tables & update_values),
+               ExcShapeTableNotFilled("update_values"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
   VectorSlice<std::vector<Vector<Number> > > val(values);
-  internal::do_function_values(dof_values.begin(), this->finite_element_output.shape_values, *fe,
+  internal::do_function_values(dof_values_ptr, this->finite_element_output.shape_values, *fe,
                                this->finite_element_output.shape_function_to_row_table, val);
 }
 
@@ -2801,6 +3327,8 @@ void FEValuesBase<dim,spacedim>::get_function_values (
           ExcNotMultiple(indices.size(), dofs_per_cell));
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
+  AssertThrow (!(released_shape_tables & update_values),
+               ExcShapeTableNotFilled("update_values"));
 
   VectorSlice<std::vector<Vector<Number> > > val(values);
   if (indices.size() <= 100)
@@ -2836,6 +3364,8 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   typedef typename InputVector::value_type Number;
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
+  AssertThrow (!(released_shape_tables & update_values),
+               ExcShapeTableNotFilled("update_values"));
 
   // Size of indices must be a multiple of dofs_per_cell such that an integer
   // number of function values is generated in each point.
@@ -2882,10 +3412,10 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_gradients,
-                                    gradients);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_gradients,
+                                    shape_gradient_components, single_precision_shape_gradients, gradients);
 }
 
 
@@ -2902,13 +3432,17 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
           ExcAccessToUninitializedField("update_gradients"));
   AssertDimension (fe->n_components(), 1);
   AssertDimension (indices.size(), dofs_per_cell);
-  if (dofs_per_cell <= 100)
+  // read the values in place if the indices form a consecutive range
+  if (const Number *dof_values_ptr = get_vector_range (fe_function, indices))
+    internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_gradients,
+                                      shape_gradient_components, single_precision_shape_gradients, gradients);
+  else if (dofs_per_cell <= 100)
     {
       Number dof_values[100];
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_derivatives(&dof_values[0], this->finite_element_output.shape_gradients,
-                                        gradients);
+                                        shape_gradient_components, single_precision_shape_gradients, gradients);
     }
   else
     {
@@ -2916,7 +3450,7 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_gradients,
-                                        gradients);
+                                        shape_gradient_components, single_precision_shape_gradients, gradients);
     }
 }
 
@@ -2933,15 +3467,17 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
   typedef typename InputVector::value_type Number;
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
+  AssertThrow (!(released_shape_tables & update_gradients),
+               ExcShapeTableNotFilled("update_gradients"));
   Assert (present_cell.get() != 0,
           ExcMessage ("FEValues object is not reinit'ed to any cell"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
   VectorSlice<std::vector<std::vector<Tensor<1,spacedim,Number> > > > grads(gradients);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_gradients,
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_gradients,
                                     *fe, this->finite_element_output.shape_function_to_row_table,
                                     grads);
 }
@@ -2963,6 +3499,8 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
           ExcNotMultiple(indices.size(), dofs_per_cell));
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
+  AssertThrow (!(released_shape_tables & update_gradients),
+               ExcShapeTableNotFilled("update_gradients"));
 
   if (indices.size() <= 100)
     {
@@ -3004,10 +3542,10 @@ get_function_hessians (const InputVector                &fe_function,
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_hessians,
-                                    hessians);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_hessians,
+                                    shape_hessian_components, single_precision_shape_hessians, hessians);
 }
 
 
@@ -3024,13 +3562,17 @@ void FEValuesBase<dim,spacedim>::get_function_hessians (
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
   AssertDimension (indices.size(), dofs_per_cell);
-  if (dofs_per_cell <= 100)
+  // read the values in place if the indices form a consecutive range
+  if (const Number *dof_values_ptr = get_vector_range (fe_function, indices))
+    internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_hessians,
+                                      shape_hessian_components, single_precision_shape_hessians, hessians);
+  else if (dofs_per_cell <= 100)
     {
       Number dof_values[100];
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_derivatives(&dof_values[0], this->finite_element_output.shape_hessians,
-                                        hessians);
+                                        shape_hessian_components, single_precision_shape_hessians, hessians);
     }
   else
     {
@@ -3038,7 +3580,7 @@ void FEValuesBase<dim,spacedim>::get_function_hessians (
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_hessians,
-                                        hessians);
+                                        shape_hessian_components, single_precision_shape_hessians, hessians);
     }
 }
 
@@ -3056,15 +3598,17 @@ get_function_hessians (const InputVector                         &fe_function,
   typedef typename InputVector::value_type Number;
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
   Assert (present_cell.get() != 0,
           ExcMessage ("FEValues object is not reinit'ed to any cell"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
   VectorSlice<std::vector<std::vector<Tensor<2,spacedim,Number> > > > hes(hessians);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_hessians,
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_hessians,
                                     *fe, this->finite_element_output.shape_function_to_row_table,
                                     hes, quadrature_points_fastest);
 }
@@ -3082,6 +3626,8 @@ void FEValuesBase<dim, spacedim>::get_function_hessians (
   typedef typename InputVector::value_type Number;
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
   Assert (indices.size() % dofs_per_cell == 0,
           ExcNotMultiple(indices.size(), dofs_per_cell));
   if (indices.size() <= 100)
@@ -3123,10 +3669,10 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_laplacians(dof_values.begin(), this->finite_element_output.shape_hessians,
-                                   laplacians);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_laplacians(dof_values_ptr, this->finite_element_output.shape_hessians,
+                                   shape_hessian_components, single_precision_shape_hessians, laplacians);
 }
 
 
@@ -3143,13 +3689,17 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe->n_components(), 1);
   AssertDimension (indices.size(), dofs_per_cell);
-  if (dofs_per_cell <= 100)
+  // read the values in place if the indices form a consecutive range
+  if (const Number *dof_values_ptr = get_vector_range (fe_function, indices))
+    internal::do_function_laplacians(dof_values_ptr, this->finite_element_output.shape_hessians,
+                                     shape_hessian_components, single_precision_shape_hessians, laplacians);
+  else if (dofs_per_cell <= 100)
     {
       Number dof_values[100];
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_laplacians(&dof_values[0], this->finite_element_output.shape_hessians,
-                                       laplacians);
+                                       shape_hessian_components, single_precision_shape_hessians, laplacians);
     }
   else
     {
@@ -3157,7 +3707,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
       for (unsigned int i=0; i<dofs_per_cell; ++i)
         dof_values[i] = get_vector_element (fe_function, indices[i]);
       internal::do_function_laplacians(dof_values.begin(), this->finite_element_output.shape_hessians,
-                                       laplacians);
+                                       shape_hessian_components, single_precision_shape_hessians, laplacians);
     }
 }
 
@@ -3174,12 +3724,14 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
           ExcMessage ("FEValues object is not reinit'ed to any cell"));
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_laplacians(dof_values.begin(), this->finite_element_output.shape_hessians,
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_laplacians(dof_values_ptr, this->finite_element_output.shape_hessians,
                                    *fe, this->finite_element_output.shape_function_to_row_table,
                                    laplacians);
 }
@@ -3200,6 +3752,8 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
           ExcNotMultiple(indices.size(), dofs_per_cell));
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
   if (indices.size() <= 100)
     {
       Number dof_values[100];
@@ -3237,6 +3791,8 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
           ExcNotMultiple(indices.size(), dofs_per_cell));
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
   if (indices.size() <= 100)
     {
       Number dof_values[100];
@@ -3277,9 +3833,9 @@ get_function_third_derivatives (const InputVector                &fe_function,
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_3rd_derivatives,
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_3rd_derivatives,
                                     third_derivatives);
 }
 
@@ -3297,7 +3853,11 @@ void FEValuesBase<dim,spacedim>::get_function_third_derivatives (
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
   AssertDimension (indices.size(), dofs_per_cell);
-  if (dofs_per_cell <= 100)
+  // read the values in place if the indices form a consecutive range
+  if (const Number *dof_values_ptr = get_vector_range (fe_function, indices))
+    internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_3rd_derivatives,
+                                      third_derivatives);
+  else if (dofs_per_cell <= 100)
     {
       Number dof_values[100];
       for (unsigned int i=0; i<dofs_per_cell; ++i)
@@ -3334,10 +3894,10 @@ get_function_third_derivatives (const InputVector                         &fe_fu
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
 
   // get function values of dofs on this cell
-  Vector<Number> dof_values (dofs_per_cell);
-  present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  Vector<Number> dof_values;
+  const Number *dof_values_ptr = get_present_cell_dof_values (fe_function, dof_values);
   VectorSlice<std::vector<std::vector<Tensor<3,spacedim,Number> > > > third(third_derivatives);
-  internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_3rd_derivatives,
+  internal::do_function_derivatives(dof_values_ptr, this->finite_element_output.shape_3rd_derivatives,
                                     *fe, this->finite_element_output.shape_function_to_row_table,
                                     third, quadrature_points_fastest);
 }
@@ -3449,7 +4009,12 @@ FEValuesBase<dim,spacedim>::memory_consumption () const
           MemoryConsumption::memory_consumption (fe) +
           MemoryConsumption::memory_consumption (fe_data) +
           MemoryConsumption::memory_consumption (*fe_data) +
-          MemoryConsumption::memory_consumption (finite_element_output));
+          MemoryConsumption::memory_consumption (finite_element_output) +
+          shape_gradient_components.memory_consumption () +
+          shape_hessian_components.memory_consumption () +
+          MemoryConsumption::memory_consumption (single_precision_shape_values) +
+          single_precision_shape_gradients.memory_consumption () +
+          single_precision_shape_hessians.memory_consumption ());
 }
 
 
@@ -3472,6 +4037,154 @@ FEValuesBase<dim,spacedim>::compute_update_flags (const UpdateFlags update_flags
 }
 
 
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::set_shape_derivative_layout (const ShapeDerivativeLayout layout)
+{
+  shape_derivative_layout = layout;
+  if (layout == array_of_structs)
+    {
+      shape_gradient_components.clear ();
+      shape_hessian_components.clear ();
+    }
+  connect_shape_table_targets ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::set_shape_table_precision (const ShapeTablePrecision precision)
+{
+  shape_table_precision = precision;
+
+  // the *_component() functions read the first table that is filled, so
+  // release those of the other precision
+  if (precision == double_precision)
+    {
+      single_precision_shape_values.reinit (0, 0);
+      single_precision_shape_gradients.clear ();
+      single_precision_shape_hessians.clear ();
+    }
+  else
+    {
+      shape_gradient_components.clear ();
+      shape_hessian_components.clear ();
+    }
+  connect_shape_table_targets ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::update_shape_derivative_components ()
+{
+  if (shape_table_precision == double_precision &&
+      shape_derivative_layout != structure_of_arrays)
+    return;
+
+  // skip the tables the finite element has already filled itself
+  const internal::FEValues::ShapeTableTargets<spacedim> *targets
+    = dynamic_cast<const internal::FEValues::ShapeTableTargets<spacedim> *>(this->fe_data.get());
+
+  if (shape_table_precision == single_precision)
+    {
+      if ((this->update_flags & update_values) &&
+          !(targets != 0 && targets->single_precision_values != 0))
+        {
+          const Table<2,double> &shape_values = this->finite_element_output.shape_values;
+          single_precision_shape_values.reinit (shape_values.size(0), shape_values.size(1));
+          for (unsigned int i=0; i<shape_values.size(0); ++i)
+            for (unsigned int q=0; q<shape_values.size(1); ++q)
+              single_precision_shape_values(i,q) = static_cast<float>(shape_values(i,q));
+        }
+      if ((this->update_flags & update_gradients) &&
+          !(targets != 0 && targets->single_precision_gradient_components != 0))
+        single_precision_shape_gradients.reinit (this->finite_element_output.shape_gradients);
+      if ((this->update_flags & update_hessians) &&
+          !(targets != 0 && targets->single_precision_hessian_components != 0))
+        single_precision_shape_hessians.reinit (this->finite_element_output.shape_hessians);
+
+      // the double precision copies are not read in this mode
+      return;
+    }
+
+  if ((this->update_flags & update_gradients) &&
+      !(targets != 0 && targets->gradient_components != 0))
+    shape_gradient_components.reinit (this->finite_element_output.shape_gradients);
+  if ((this->update_flags & update_hessians) &&
+      !(targets != 0 && targets->hessian_components != 0))
+    shape_hessian_components.reinit (this->finite_element_output.shape_hessians);
+}
+
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::connect_shape_table_targets ()
+{
+  internal::FEValues::ShapeTableTargets<spacedim> *targets
+    = dynamic_cast<internal::FEValues::ShapeTableTargets<spacedim> *>(this->fe_data.get());
+  released_shape_tables = update_default;
+  if (targets == 0)
+    return;
+
+  // the views for vector- and tensor-valued quantities read the tables of
+  // finite_element_output, so keep these as long as there are any. this
+  // is only the case for vector-valued elements or in 1d
+  const bool direct = (fe->n_components() == 1 &&
+                       fe_values_views_cache.vectors.empty() &&
+                       fe_values_views_cache.symmetric_second_order_tensors.empty() &&
+                       fe_values_views_cache.second_order_tensors.empty());
+  const bool single = (direct && shape_table_precision == single_precision);
+  const bool components = (direct && shape_table_precision == double_precision &&
+                           shape_derivative_layout == structure_of_arrays);
+
+  if (this->update_flags & update_values)
+    {
+      targets->single_precision_values = (single ? &single_precision_shape_values : 0);
+      if (single)
+        {
+          Table<2,double> empty_table;
+          this->finite_element_output.shape_values.swap (empty_table);
+          released_shape_tables |= update_values;
+        }
+      else if (this->finite_element_output.shape_values.n_rows() == 0)
+        this->finite_element_output.shape_values.reinit (dofs_per_cell, n_quadrature_points);
+    }
+
+  if (this->update_flags & update_gradients)
+    {
+      targets->gradient_components = (components ? &shape_gradient_components : 0);
+      targets->single_precision_gradient_components = (single ? &single_precision_shape_gradients : 0);
+      if (components || single)
+        {
+          Table<2,Tensor<1,spacedim> > empty_table;
+          this->finite_element_output.shape_gradients.swap (empty_table);
+          released_shape_tables |= update_gradients;
+        }
+      else if (this->finite_element_output.shape_gradients.n_rows() == 0)
+        this->finite_element_output.shape_gradients.reinit (dofs_per_cell, n_quadrature_points);
+    }
+
+  if (this->update_flags & update_hessians)
+    {
+      targets->hessian_components = (components ? &shape_hessian_components : 0);
+      targets->single_precision_hessian_components = (single ? &single_precision_shape_hessians : 0);
+      if (components || single)
+        {
+          Table<2,Tensor<2,spacedim> > empty_table;
+          this->finite_element_output.shape_hessians.swap (empty_table);
+          released_shape_tables |= update_hessians;
+        }
+      else if (this->finite_element_output.shape_hessians.n_rows() == 0)
+        this->finite_element_output.shape_hessians.reinit (dofs_per_cell, n_quadrature_points);
+    }
+}
+
+
+
 template <int dim, int spacedim>
 void
 FEValuesBase< dim, spacedim >::invalidate_present_cell ()
@@ -3814,6 +4527,7 @@ void FEValues<dim,spacedim>::reinit
                                  this->mapping_output,
                                  *this->fe_data,
                                  this->finite_element_output);
+   this->update_shape_derivative_components ();
    
 
 
@@ -3869,6 +4583,7 @@ FEValues<dim,spacedim>::reinit
                                  this->mapping_output,
                                  *this->fe_data,
                                  this->finite_element_output);
+   this->update_shape_derivative_components ();
    
 
 }
@@ -3910,6 +4625,7 @@ void FEValues<dim,spacedim>::do_reinit ()
                                 this->mapping_output,
                                 *this->fe_data,
                                 this->finite_element_output);
+  this->update_shape_derivative_components ();
 }
 
 
@@ -4128,6 +4844,7 @@ void FEFaceValues<dim,spacedim>::do_reinit (const unsigned int face_no)
                                      this->mapping_output,
                                      *this->fe_data,
                                      this->finite_element_output);
+  this->update_shape_derivative_components ();
 }
 
 
@@ -4383,6 +5100,7 @@ void FESubfaceValues<dim,spacedim>::do_reinit (const unsigned int face_no,
                                         this->mapping_output,
                                         *this->fe_data,
                                         this->finite_element_output);
+  this->update_shape_derivative_components ();
 }
 
 
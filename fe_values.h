@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/point.h>
@@ -1329,6 +1330,297 @@ namespace internal
 
 
 
+namespace internal
+{
+  namespace FEValues
+  {
+    /**
+     * Describe which tensor components of a shape function derivative of
+     * rank @p order are stored by ShapeDerivativeComponents. In general,
+     * these are all components of the tensor.
+     */
+    template <int order, int spacedim>
+    struct ShapeDerivativeComponentTraits
+    {
+      /**
+       * Number of components stored per quadrature point.
+       */
+      static const unsigned int n_components
+        = dealii::Tensor<order,spacedim>::n_independent_components;
+
+      /**
+       * Return the indices of the tensor entry stored as component
+       * @p component.
+       */
+      static
+      TableIndices<order>
+      component_indices (const unsigned int component)
+      {
+        return dealii::Tensor<order,spacedim>::unrolled_to_component_indices (component);
+      }
+
+      /**
+       * Set the tensor entry stored as component @p component of
+       * @p derivative to @p value.
+       */
+      template <typename Number>
+      static
+      void
+      set_component (dealii::Tensor<order,spacedim,Number> &derivative,
+                     const unsigned int                     component,
+                     const Number                          &value)
+      {
+        derivative[component_indices (component)] = value;
+      }
+    };
+
+
+
+    /**
+     * Specialization for Hessians. Second derivatives are symmetric, so
+     * only the <tt>spacedim*(spacedim+1)/2</tt> entries on and above the
+     * diagonal are stored, in the order used by SymmetricTensor. This
+     * saves one third of the memory and memory traffic in 3d and one
+     * quarter in 2d.
+     */
+    template <int spacedim>
+    struct ShapeDerivativeComponentTraits<2,spacedim>
+    {
+      static const unsigned int n_components
+        = dealii::SymmetricTensor<2,spacedim>::n_independent_components;
+
+      static
+      TableIndices<2>
+      component_indices (const unsigned int component)
+      {
+        return dealii::SymmetricTensor<2,spacedim>::unrolled_to_component_indices (component);
+      }
+
+      /**
+       * Set both the entry stored as component @p component and its
+       * transpose.
+       */
+      template <typename Number>
+      static
+      void
+      set_component (dealii::Tensor<2,spacedim,Number> &derivative,
+                     const unsigned int                 component,
+                     const Number                      &value)
+      {
+        const TableIndices<2> indices = component_indices (component);
+        derivative[indices[0]][indices[1]] = value;
+        derivative[indices[1]][indices[0]] = value;
+      }
+    };
+
+
+
+    /**
+     * A structure-of-arrays copy of a table of shape function derivatives
+     * of rank @p order, such as FiniteElementRelatedData::shape_gradients or
+     * FiniteElementRelatedData::shape_hessians. Where those tables store one
+     * tensor per shape function and quadrature point, this class stores one
+     * contiguous array of quadrature point values per tensor component and
+     * row of the original table. For Hessians, only the components on and
+     * above the diagonal are stored, see ShapeDerivativeComponentTraits.
+     * Each such array starts at an address aligned for vectorized access
+     * and is padded to a multiple of the alignment, so that the contraction
+     * of the derivatives with the degrees of freedom of a cell reduces to a
+     * sequence of unit-stride multiply-add loops.
+     *
+     * The values are stored in the type @p Number, which is either
+     * @p double or, for the single precision mode selected through
+     * FEValuesBase::set_shape_table_precision(), @p float.
+     *
+     * Objects of this class are filled by FEValuesBase after the finite
+     * element has written its output if the structure-of-arrays layout or
+     * single precision tables were requested, or directly by finite
+     * elements that support it, see ShapeTableTargets.
+     */
+    template <int order, int spacedim, typename Number = double>
+    class ShapeDerivativeComponents
+    {
+    public:
+      /**
+       * Number of tensor components stored per row and quadrature point.
+       * For Hessians, this is the number of independent components of a
+       * symmetric tensor.
+       */
+      static const unsigned int n_components
+        = ShapeDerivativeComponentTraits<order,spacedim>::n_components;
+
+      /**
+       * Return the indices of the tensor entry stored as component
+       * @p component.
+       */
+      static
+      TableIndices<order>
+      component_indices (const unsigned int component);
+
+      /**
+       * Set the entries of @p derivative that correspond to the stored
+       * component @p component to @p value. For Hessians, this sets both
+       * the entry and its transpose.
+       */
+      template <typename OutputNumber>
+      static
+      void
+      set_component (dealii::Tensor<order,spacedim,OutputNumber> &derivative,
+                     const unsigned int                           component,
+                     const OutputNumber                          &value);
+
+      /**
+       * Constructor. Create an empty object.
+       */
+      ShapeDerivativeComponents ();
+
+      /**
+       * Resize this object to match the size of @p shape_derivatives and
+       * copy its contents, component by component, converting them to
+       * @p Number.
+       */
+      void reinit (const dealii::Table<2,dealii::Tensor<order,spacedim> > &shape_derivatives);
+
+      /**
+       * Resize this object to hold @p n_rows rows with
+       * @p n_quadrature_points values each, for a finite element that
+       * writes the components itself through the non-const component()
+       * function. The padding at the end of each array is set to zero, all
+       * other values are left uninitialized.
+       */
+      void reinit (const unsigned int n_rows,
+                   const unsigned int n_quadrature_points);
+
+      /**
+       * Release all memory held by this object.
+       */
+      void clear ();
+
+      /**
+       * Return whether this object holds any data.
+       */
+      bool empty () const;
+
+      /**
+       * Number of rows, i.e., nonzero shape function components, stored.
+       */
+      unsigned int n_rows () const;
+
+      /**
+       * Number of quadrature points stored for each row.
+       */
+      unsigned int n_quadrature_points () const;
+
+      /**
+       * Return a pointer to the values of the unrolled tensor component
+       * @p component of the derivatives of the shape function stored in row
+       * @p row, at all quadrature points. The pointer is suitably aligned
+       * for vectorized access.
+       */
+      const Number *component (const unsigned int component,
+                               const unsigned int row) const;
+
+      /**
+       * Same as above, but for writing the values.
+       */
+      Number *component (const unsigned int component,
+                         const unsigned int row);
+
+      /**
+       * Return the derivative of the shape function stored in row @p row at
+       * quadrature point @p q_point, assembled from its components. This is
+       * slow compared to the functions above, which give access to all
+       * quadrature points at once.
+       */
+      dealii::Tensor<order,spacedim> derivative (const unsigned int row,
+                                                 const unsigned int q_point) const;
+
+      /**
+       * Determine an estimate for the memory consumption (in bytes) of this
+       * object.
+       */
+      std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * Number of rows of the table this object was last filled from.
+       */
+      unsigned int n_table_rows;
+
+      /**
+       * Number of quadrature points of the table this object was last
+       * filled from.
+       */
+      unsigned int n_q_points;
+
+      /**
+       * Distance between the starts of two consecutive arrays in #data,
+       * i.e., n_q_points rounded up to the alignment.
+       */
+      unsigned int row_length;
+
+      /**
+       * The values, with the quadrature point index running fastest, then
+       * the row, and the tensor component slowest.
+       */
+      AlignedVector<Number> data;
+    };
+
+
+
+    /**
+     * Places into which a finite element writes parts of its output
+     * directly, instead of into FiniteElementRelatedData. A finite element
+     * opts in by deriving the internal data object it returns from
+     * FiniteElement::get_data() and friends also from this class. If the
+     * structure-of-arrays layout or single precision tables are selected,
+     * FEValuesBase then points the members of this class at its own tables
+     * and drops the corresponding tables of FiniteElementRelatedData, so
+     * that the data are written only once. At most one of the pointers for
+     * each quantity is set. The element has to check for each pointer
+     * whether it is set, and fill FiniteElementRelatedData as usual if
+     * none is.
+     *
+     * FEValuesBase only sets the pointers for elements with a single vector
+     * component, and only if no views for vector- or tensor-valued
+     * quantities exist, see FEValuesBase::ShapeDerivativeLayout.
+     */
+    template <int spacedim>
+    class ShapeTableTargets
+    {
+    public:
+      /**
+       * Constructor. Set all pointers to null.
+       */
+      ShapeTableTargets ();
+
+      /**
+       * If not null, the shape function gradients are written here instead
+       * of into FiniteElementRelatedData::shape_gradients.
+       */
+      ShapeDerivativeComponents<1,spacedim> *gradient_components;
+
+      /**
+       * If not null, the independent components of the shape function
+       * Hessians are written here instead of into
+       * FiniteElementRelatedData::shape_hessians.
+       */
+      ShapeDerivativeComponents<2,spacedim> *hessian_components;
+
+      /**
+       * If not null, the shape function values, gradients and independent
+       * Hessian components are written here in single precision instead of
+       * into FiniteElementRelatedData.
+       */
+      Table<2,float>                               *single_precision_values;
+      ShapeDerivativeComponents<1,spacedim,float> *single_precision_gradient_components;
+      ShapeDerivativeComponents<2,spacedim,float> *single_precision_hessian_components;
+    };
+  }
+}
+
+
+
 /**
  * FEValues, FEFaceValues and FESubfaceValues objects are interfaces to finite
  * element and mapping classes on the one hand side, to cells and quadrature
@@ -1479,6 +1771,109 @@ public:
   ~FEValuesBase ();
 
 
+  /**
+   * Layouts in which the gradients and Hessians of the shape functions can
+   * be made available to the <tt>get_function_*</tt> functions of this
+   * class and of the FEValuesViews::Scalar class.
+   *
+   * <ul>
+   * <li> @p array_of_structs: use the tables filled by the finite element
+   * directly, with one tensor per shape function and quadrature point. This
+   * is the default.
+   * <li> @p structure_of_arrays: after each <tt>reinit</tt> call, copy
+   * gradients and Hessians into one aligned array per derivative direction
+   * and shape function (see internal::FEValues::ShapeDerivativeComponents)
+   * and evaluate finite element fields from these. Hessians are stored in
+   * compressed form, keeping only their independent components since they
+   * are symmetric. This costs one
+   * additional pass over the derivative tables per cell, but makes the
+   * evaluation loops unit-stride and hence amenable to vectorization; it
+   * pays off if several fields are evaluated on each cell.
+   * </ul>
+   *
+   * Finite elements that support it, currently FE_DGT, write the
+   * structure-of-arrays layout directly (see
+   * internal::FEValues::ShapeTableTargets), in which case the tables of the
+   * first layout are not filled at all. shape_grad_component(),
+   * shape_hessian_component() and the FEValuesViews::Scalar class then
+   * assemble the tensors from their components, whereas shape_grad() and
+   * shape_hessian(), which return references into these tables, and the
+   * <tt>get_function_*</tt> functions for vector-valued fields throw an
+   * exception of type ExcShapeTableNotFilled. This is only done for
+   * elements with a single vector component, and not in 1d, where the
+   * views for vector- and tensor-valued quantities, which read the tables
+   * of the first layout, are available for such elements as well.
+   */
+  enum ShapeDerivativeLayout
+  {
+    array_of_structs,
+    structure_of_arrays
+  };
+
+  /**
+   * Select the layout in which shape function gradients and Hessians are
+   * used when evaluating finite element fields. The choice takes effect
+   * with the next call to <tt>reinit</tt>.
+   */
+  void set_shape_derivative_layout (const ShapeDerivativeLayout layout);
+
+  /**
+   * Return the layout selected by set_shape_derivative_layout().
+   */
+  ShapeDerivativeLayout get_shape_derivative_layout () const;
+
+  /**
+   * Precision in which shape function values, gradients and Hessians are
+   * stored for the evaluation of finite element fields.
+   *
+   * <ul>
+   * <li> @p double_precision: use the tables filled by the finite element.
+   * This is the default.
+   * <li> @p single_precision: store shape function values, gradients and
+   * Hessians as <tt>float</tt>. Derivatives are stored in the
+   * structure-of-arrays layout described above, irrespective of the choice
+   * made by set_shape_derivative_layout(). The get_function_values()
+   * family of functions of this class and of FEValuesViews::Scalar then
+   * reads the single precision tables but still accumulates in the number
+   * type of the vector that is evaluated, halving the memory traffic for
+   * the shape tables at the cost of a relative accuracy of about $10^{-7}$
+   * in the shape functions.
+   * </ul>
+   *
+   * Finite elements that support it, currently FE_DGT, write the single
+   * precision tables directly (see internal::FEValues::ShapeTableTargets),
+   * subject to the same conditions as for the structure-of-arrays layout.
+   * The double precision tables are then not filled at all, and the
+   * functions reading them behave as described for the derivatives above:
+   * shape_value(), shape_grad(), shape_hessian() and the
+   * <tt>get_function_*</tt> functions for vector-valued fields throw an
+   * exception of type ExcShapeTableNotFilled, whereas the *_component()
+   * functions and the FEValuesViews::Scalar class read the single precision
+   * tables. For other elements, the tables filled by the element are
+   * converted after each <tt>reinit</tt> call, and all functions remain
+   * available.
+   *
+   * The JxW values are computed by the mapping and always stored in double
+   * precision.
+   */
+  enum ShapeTablePrecision
+  {
+    double_precision,
+    single_precision
+  };
+
+  /**
+   * Select the precision in which shape tables are used when evaluating
+   * finite element fields. The choice takes effect with the next call to
+   * <tt>reinit</tt>.
+   */
+  void set_shape_table_precision (const ShapeTablePrecision precision);
+
+  /**
+   * Return the precision selected by set_shape_table_precision().
+   */
+  ShapeTablePrecision get_shape_table_precision () const;
+
   /// @name ShapeAccess Access to shape function values. These fields are filled by the finite element.
   //@{
 
@@ -2582,6 +2977,23 @@ public:
    * @ingroup Exceptions
    */
   DeclException0 (ExcFENotPrimitive);
+  /**
+   * This exception is thrown if a function is called that reads a table of
+   * shape function data that the finite element did not fill, since it
+   * wrote the data directly in the layout or precision selected by
+   * set_shape_derivative_layout() or set_shape_table_precision().
+   *
+   * @ingroup Exceptions
+   */
+  DeclException1 (ExcShapeTableNotFilled,
+                  char *,
+                  << "You are requesting information from an FEValues/FEFaceValues/FESubfaceValues "
+                  << "object through a function that reads the tables filled by the finite element. "
+                  << "For the <" << arg1 << "> flag, however, the finite element has written its "
+                  << "output only in the layout or precision selected by set_shape_derivative_layout() "
+                  << "or set_shape_table_precision(). Use the *_component() functions or the "
+                  << "FEValuesViews::Scalar class instead, or select the array_of_structs layout "
+                  << "and double precision.");
 
 protected:
   /**
@@ -2694,6 +3106,60 @@ protected:
    */
   dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> finite_element_output;
 
+  /**
+   * The layout selected by set_shape_derivative_layout().
+   */
+  ShapeDerivativeLayout shape_derivative_layout;
+
+  /**
+   * Structure-of-arrays copies of the shape function gradients and Hessians
+   * stored in #finite_element_output. They are only filled if
+   * #shape_derivative_layout equals @p structure_of_arrays.
+   */
+  dealii::internal::FEValues::ShapeDerivativeComponents<1,spacedim> shape_gradient_components;
+  dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim> shape_hessian_components;
+
+  /**
+   * The update flags of those tables of #finite_element_output that the
+   * finite element does not fill, since it writes its output directly into
+   * the tables of this class instead, see connect_shape_table_targets().
+   * Functions that read these tables throw an exception of type
+   * ExcShapeTableNotFilled.
+   */
+  UpdateFlags released_shape_tables;
+
+  /**
+   * The precision selected by set_shape_table_precision().
+   */
+  ShapeTablePrecision shape_table_precision;
+
+  /**
+   * Single precision versions of the shape function values, gradients and
+   * Hessians. They are only filled if #shape_table_precision equals
+   * @p single_precision, either directly by the finite element or by
+   * conversion of the tables in #finite_element_output.
+   */
+  Table<2,float> single_precision_shape_values;
+  dealii::internal::FEValues::ShapeDerivativeComponents<1,spacedim,float> single_precision_shape_gradients;
+  dealii::internal::FEValues::ShapeDerivativeComponents<2,spacedim,float> single_precision_shape_hessians;
+
+  /**
+   * Refill #shape_gradient_components and #shape_hessian_components from
+   * #finite_element_output if the structure-of-arrays layout is selected,
+   * and the single precision tables if single precision is selected,
+   * except for the tables the finite element has filled itself. Called at
+   * the end of the <tt>do_reinit</tt> functions of derived classes.
+   */
+  void update_shape_derivative_components ();
+
+  /**
+   * If the finite element writes some of its output directly (see
+   * internal::FEValues::ShapeTableTargets), point it at the tables that
+   * the present layout and precision require and release the tables of
+   * #finite_element_output that it no longer fills. Called whenever the
+   * layout or the precision changes.
+   */
+  void connect_shape_table_targets ();
 
   /**
    * Original update flags handed to the constructor of FEValues.
@@ -2725,6 +3191,21 @@ protected:
   void
   check_cell_similarity (const typename Triangulation<dim,spacedim>::cell_iterator &cell);
 
+  /**
+   * Return a pointer to the values of the degrees of freedom of the present
+   * cell in @p fe_function. If the cell is active, its DoF indices form a
+   * consecutive range (as is the case for discontinuous elements such as
+   * FE_DGT whose DoFs are numbered cell by cell), and @p fe_function stores
+   * its elements contiguously, the returned pointer points directly into
+   * the storage of @p fe_function and @p dof_values is left untouched.
+   * Otherwise, the values are gathered into @p dof_values, which is resized
+   * as necessary, and a pointer to its first element is returned.
+   */
+  template <class InputVector>
+  const typename InputVector::value_type *
+  get_present_cell_dof_values (const InputVector                        &fe_function,
+                               Vector<typename InputVector::value_type> &dof_values) const;
+
 private:
   /**
    * Copy constructor. Since objects of this class are not copyable, we make
@@ -3249,9 +3730,15 @@ namespace FEValuesViews
     // except that here we know the component as fixed and we have
     // pre-computed and cached a bunch of information. See the comments there.
     if (shape_function_data[shape_function].is_nonzero_shape_function_component)
-      return fe_values.finite_element_output.shape_values(shape_function_data[shape_function]
-                                                          .row_index,
-                                                          q_point);
+      {
+        if (fe_values.released_shape_tables & update_values)
+          return fe_values.single_precision_shape_values(shape_function_data[shape_function]
+                                                         .row_index,
+                                                         q_point);
+        return fe_values.finite_element_output.shape_values(shape_function_data[shape_function]
+                                                            .row_index,
+                                                            q_point);
+      }
     else
       return 0;
   }
@@ -3278,8 +3765,16 @@ namespace FEValuesViews
     // pre-computed and cached a bunch of
     // information. See the comments there.
     if (shape_function_data[shape_function].is_nonzero_shape_function_component)
-      return fe_values.finite_element_output.shape_gradients[shape_function_data[shape_function]
-                                                             .row_index][q_point];
+      {
+        if (!fe_values.shape_gradient_components.empty())
+          return fe_values.shape_gradient_components.derivative (shape_function_data[shape_function].row_index,
+                                                                 q_point);
+        if (fe_values.released_shape_tables & update_gradients)
+          return fe_values.single_precision_shape_gradients.derivative (shape_function_data[shape_function].row_index,
+                                                                        q_point);
+        return fe_values.finite_element_output.shape_gradients[shape_function_data[shape_function]
+                                                               .row_index][q_point];
+      }
     else
       return gradient_type();
   }
@@ -3305,7 +3800,15 @@ namespace FEValuesViews
     // pre-computed and cached a bunch of
     // information. See the comments there.
     if (shape_function_data[shape_function].is_nonzero_shape_function_component)
-      return fe_values.finite_element_output.shape_hessians[shape_function_data[shape_function].row_index][q_point];
+      {
+        if (!fe_values.shape_hessian_components.empty())
+          return fe_values.shape_hessian_components.derivative (shape_function_data[shape_function].row_index,
+                                                                q_point);
+        if (fe_values.released_shape_tables & update_hessians)
+          return fe_values.single_precision_shape_hessians.derivative (shape_function_data[shape_function].row_index,
+                                                                       q_point);
+        return fe_values.finite_element_output.shape_hessians[shape_function_data[shape_function].row_index][q_point];
+      }
     else
       return hessian_type();
   }
@@ -4025,6 +4528,126 @@ namespace FEValuesViews
 
 
 
+/*------------------------ Inline functions: ShapeDerivativeComponents ------------------------*/
+
+namespace internal
+{
+  namespace FEValues
+  {
+    template <int order, int spacedim, typename Number>
+    inline
+    bool
+    ShapeDerivativeComponents<order,spacedim,Number>::empty () const
+    {
+      return data.size() == 0;
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    unsigned int
+    ShapeDerivativeComponents<order,spacedim,Number>::n_rows () const
+    {
+      return n_table_rows;
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    unsigned int
+    ShapeDerivativeComponents<order,spacedim,Number>::n_quadrature_points () const
+    {
+      return n_q_points;
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    TableIndices<order>
+    ShapeDerivativeComponents<order,spacedim,Number>::component_indices (const unsigned int component)
+    {
+      return ShapeDerivativeComponentTraits<order,spacedim>::component_indices (component);
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    template <typename OutputNumber>
+    inline
+    void
+    ShapeDerivativeComponents<order,spacedim,Number>::set_component (dealii::Tensor<order,spacedim,OutputNumber> &derivative,
+                                                                     const unsigned int                           component,
+                                                                     const OutputNumber                          &value)
+    {
+      ShapeDerivativeComponentTraits<order,spacedim>::set_component (derivative, component, value);
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    const Number *
+    ShapeDerivativeComponents<order,spacedim,Number>::component (const unsigned int component,
+                                                                 const unsigned int row) const
+    {
+      Assert (component < n_components,
+              ExcIndexRange (component, 0, n_components));
+      Assert (row < n_table_rows,
+              ExcIndexRange (row, 0, n_table_rows));
+      return data.begin() + (static_cast<std::size_t>(component)*n_table_rows + row) * row_length;
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    Number *
+    ShapeDerivativeComponents<order,spacedim,Number>::component (const unsigned int component,
+                                                                 const unsigned int row)
+    {
+      Assert (component < n_components,
+              ExcIndexRange (component, 0, n_components));
+      Assert (row < n_table_rows,
+              ExcIndexRange (row, 0, n_table_rows));
+      return data.begin() + (static_cast<std::size_t>(component)*n_table_rows + row) * row_length;
+    }
+
+
+
+    template <int order, int spacedim, typename Number>
+    inline
+    dealii::Tensor<order,spacedim>
+    ShapeDerivativeComponents<order,spacedim,Number>::derivative (const unsigned int row,
+                                                                  const unsigned int q_point) const
+    {
+      Assert (q_point < n_q_points,
+              ExcIndexRange (q_point, 0, n_q_points));
+      dealii::Tensor<order,spacedim> result;
+      for (unsigned int c=0; c<n_components; ++c)
+        set_component (result, c, static_cast<double>(component (c, row)[q_point]));
+      return result;
+    }
+
+
+
+    template <int spacedim>
+    inline
+    ShapeTableTargets<spacedim>::ShapeTableTargets ()
+      :
+      gradient_components (0),
+      hessian_components (0),
+      single_precision_values (0),
+      single_precision_gradient_components (0),
+      single_precision_hessian_components (0)
+    {}
+  }
+}
+
+
+
 /*------------------------ Inline functions: FEValuesBase ------------------------*/
 
 
@@ -4101,6 +4724,8 @@ FEValuesBase<dim,spacedim>::shape_value (const unsigned int i,
           ExcAccessToUninitializedField("update_values"));
   Assert (fe->is_primitive (i),
           ExcShapeFunctionNotPrimitive(i));
+  AssertThrow (!(released_shape_tables & update_values),
+               ExcShapeTableNotFilled("update_values"));
 
   // if the entire FE is primitive,
   // then we can take a short-cut:
@@ -4149,6 +4774,8 @@ FEValuesBase<dim,spacedim>::shape_value_component (const unsigned int i,
   // there
   const unsigned int
   row = this->finite_element_output.shape_function_to_row_table[i * fe->n_components() + component];
+  if (released_shape_tables & update_values)
+    return single_precision_shape_values(row, j);
   return this->finite_element_output.shape_values(row, j);
 }
 
@@ -4166,6 +4793,8 @@ FEValuesBase<dim,spacedim>::shape_grad (const unsigned int i,
           ExcAccessToUninitializedField("update_gradients"));
   Assert (fe->is_primitive (i),
           ExcShapeFunctionNotPrimitive(i));
+  AssertThrow (!(released_shape_tables & update_gradients),
+               ExcShapeTableNotFilled("update_gradients"));
 
   // if the entire FE is primitive,
   // then we can take a short-cut:
@@ -4214,6 +4843,10 @@ FEValuesBase<dim,spacedim>::shape_grad_component (const unsigned int i,
   // there
   const unsigned int
   row = this->finite_element_output.shape_function_to_row_table[i * fe->n_components() + component];
+  if (!shape_gradient_components.empty())
+    return shape_gradient_components.derivative (row, j);
+  if (released_shape_tables & update_gradients)
+    return single_precision_shape_gradients.derivative (row, j);
   return this->finite_element_output.shape_gradients[row][j];
 }
 
@@ -4231,6 +4864,8 @@ FEValuesBase<dim,spacedim>::shape_hessian (const unsigned int i,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (fe->is_primitive (i),
           ExcShapeFunctionNotPrimitive(i));
+  AssertThrow (!(released_shape_tables & update_hessians),
+               ExcShapeTableNotFilled("update_hessians"));
 
   // if the entire FE is primitive,
   // then we can take a short-cut:
@@ -4279,6 +4914,10 @@ FEValuesBase<dim,spacedim>::shape_hessian_component (const unsigned int i,
   // there
   const unsigned int
   row = this->finite_element_output.shape_function_to_row_table[i * fe->n_components() + component];
+  if (!shape_hessian_components.empty())
+    return shape_hessian_components.derivative (row, j);
+  if (released_shape_tables & update_hessians)
+    return single_precision_shape_hessians.derivative (row, j);
   return this->finite_element_output.shape_hessians[row][j];
 }
 
@@ -4378,6 +5017,26 @@ FEValuesBase<dim,spacedim>::get_update_flags () const
 
 
 
+template <int dim, int spacedim>
+inline
+typename FEValuesBase<dim,spacedim>::ShapeDerivativeLayout
+FEValuesBase<dim,spacedim>::get_shape_derivative_layout () const
+{
+  return shape_derivative_layout;
+}
+
+
+
+template <int dim, int spacedim>
+inline
+typename FEValuesBase<dim,spacedim>::ShapeTablePrecision
+FEValuesBase<dim,spacedim>::get_shape_table_precision () const
+{
+  return shape_table_precision;
+}
+
+
+
 template <int dim, int spacedim>
 inline
 const std::vector<Point<spacedim> > &
@@ -4402,6 +5061,7 @@ FEValuesBase<dim,spacedim>::get_JxW_values () const
 
 
 
+
 template <int dim, int spacedim>
 inline
 const std::vector<DerivativeForm<1,dim,spacedim> > &